@@ -0,0 +1,9 @@
+$(srcdir)/eric_error_table.h: $(srcdir)/include/eric_fehlercodes.h $(srcdir)/eric_error_table.awk
+	$(AWK) -f $(srcdir)/eric_error_table.awk $(srcdir)/include/eric_fehlercodes.h > $@
+
+php_eric.lo: $(srcdir)/eric_error_table.h
+
+$(srcdir)/tests/stub/libericapi.so: $(srcdir)/tests/stub/ericapi_stub.c
+	$(CC) -shared -fPIC -pthread -I$(srcdir) -o $@ $(srcdir)/tests/stub/ericapi_stub.c
+
+test: $(srcdir)/tests/stub/libericapi.so
@@ -0,0 +1,45 @@
+<?php
+/*
+ * copies return buffers of 1KB, 100KB and 10MB into php strings through eric_process()
+ *
+ * run against the stub library so only the extension side is measured:
+ *   cc -shared -fPIC -pthread -I. -o tests/stub/libericapi.so tests/stub/ericapi_stub.c
+ *   php -d extension=modules/eric.so -d eric.library_path=$PWD/tests/stub/libericapi.so bench/return_buffer.php [scale]
+ */
+
+$scale = max(1, (int) ($argv[1] ?? 1));
+$sizes = ['1KB' => [1024, 20000], '100KB' => [100 * 1024, 2000], '10MB' => [10 * 1024 * 1024, 50]];
+
+if(!eric_init()) {
+    fwrite(STDERR, "eric_init failed: " . eric_get_error_code() . "\n");
+    exit(1);
+}
+
+printf("%-6s %10s %12s %12s %12s\n", 'size', 'calls', 'total ms', 'us/call', 'MB/s');
+foreach($sizes as $label => [$size, $calls]) {
+    putenv("ERIC_STUB_RETURN_SIZE=$size");
+    $calls *= $scale;
+
+    eric_process($response, 'UStVA_2024', '<Elster/>', ERIC_VALIDIERE); /* warm the buffer pool */
+    $start = hrtime(true);
+    for($i = 0; $i < $calls; $i++) {
+        $xml = eric_process($response, 'UStVA_2024', '<Elster/>', ERIC_VALIDIERE);
+        if(strlen($xml) !== $size) {
+            fwrite(STDERR, "unexpected return size " . strlen($xml) . "\n");
+            exit(1);
+        }
+    }
+    $ns = hrtime(true) - $start;
+
+    printf(
+        "%-6s %10d %12.2f %12.2f %12.1f\n",
+        $label,
+        $calls,
+        $ns / 1e6,
+        $ns / 1e3 / $calls,
+        $size * $calls / 1048576 / ($ns / 1e9)
+    );
+}
+
+putenv('ERIC_STUB_RETURN_SIZE');
+eric_close();
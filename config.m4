@@ -1 +1,4 @@
 PHP_NEW_EXTENSION(eric, php_eric.c, "yes")
+PHP_ADD_LIBRARY(pthread, 1, ERIC_SHARED_LIBADD)
+PHP_SUBST(ERIC_SHARED_LIBADD)
+PHP_ADD_MAKEFILE_FRAGMENT
@@ -0,0 +1,60 @@
+# generates eric_error_table.h from include/eric_fehlercodes.h:
+#   awk -f eric_error_table.awk include/eric_fehlercodes.h > eric_error_table.h
+
+BEGIN {
+    print "/* generated from include/eric_fehlercodes.h by eric_error_table.awk, do not edit */"
+    print "/* ERIC_ERROR_ENTRY(code, category, retry) */"
+
+    # failed before any data left, sending again cannot duplicate a submission
+    list("ERIC_TRANSFER_ERR_CONNECTSERVER ERIC_TRANSFER_ERR_PROXYCONNECT ERIC_TRANSFER_ERR_SEND_INIT " \
+        "ERIC_CRYPT_E_BUSY ERIC_IO_MASTERDATENSERVICE_NICHT_VERFUEGBAR", safe)
+    # may fail after ELSTER accepted the data, only sent again with eric.retry_resend
+    list("ERIC_TRANSFER_COM_ERROR ERIC_TRANSFER_ERR_SEND ERIC_TRANSFER_ERR_NORESPONSE ERIC_TRANSFER_ERR_TIMEOUT", resend)
+    # reported back by the ELSTER or eID servers
+    list("ERIC_TRANSFER_ERR_XML_THEADER ERIC_TRANSFER_ERR_XML_NHEADER ERIC_TRANSFER_EID_SERVERFEHLER", server)
+}
+
+function list(names, set,    n, i, parts) {
+    n = split(names, parts, " ")
+    for(i = 1; i <= n; i++) {
+        set[parts[i]] = 1
+    }
+}
+
+function retry(name) {
+    if(name in safe) {
+        return "SAFE"
+    }
+    if(name in resend) {
+        return "RESEND"
+    }
+
+    return "NEVER"
+}
+
+function category(name) {
+    if(name in server) {
+        return "SERVER"
+    }
+    if(name ~ /^ERIC_TRANSFER_/) {
+        return "TRANSFER"
+    }
+    if(name ~ /^ERIC_CRYPT_/) {
+        return "CRYPT"
+    }
+    if(name ~ /^ERIC_IO_/) {
+        return "IO"
+    }
+    if(name ~ /^ERIC_PRINT_/) {
+        return "PRINT"
+    }
+
+    return "GLOBAL"
+}
+
+/^[ \t]*ERIC_[A-Z0-9_]+[ \t]*=[ \t]*[0-9]+/ {
+    line = $0
+    gsub(/[ \t,]/, "", line)
+    split(line, parts, "=")
+    printf "ERIC_ERROR_ENTRY(%s, ERIC_ERROR_CATEGORY_%s, ERIC_ERROR_RETRY_%s)\n", parts[1], category(parts[1]), retry(parts[1])
+}
@@ -0,0 +1,213 @@
+/* generated from include/eric_fehlercodes.h by eric_error_table.awk, do not edit */
+/* ERIC_ERROR_ENTRY(code, category, retry) */
+ERIC_ERROR_ENTRY(ERIC_OK, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UNKNOWN, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_PRUEF_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_HINWEISE, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_FEHLERMELDUNG_NICHT_VORHANDEN, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_KEINE_DATEN_VORHANDEN, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NICHT_GENUEGEND_ARBEITSSPEICHER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_DATEI_NICHT_GEFUNDEN, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_HERSTELLER_ID_NICHT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ILLEGAL_STATE, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_FUNKTION_NICHT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ECHTFALL_NICHT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NO_VERSAND_IN_BETA_VERSION, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_TESTMERKER_UNGUELTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_DATENSATZ_ZU_GROSS, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_VERSCHLUESSELUNGS_PARAMETER_NICHT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NUR_PORTALZERTIFIKAT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ABRUFCODE_NICHT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ERROR_XML_CREATE, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_TEXTPUFFERGROESSE_FIX, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_INTERNER_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ARITHMETIKFEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_STEUERNUMMER_FALSCHE_LAENGE, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_STEUERNUMMER_NICHT_NUMERISCH, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_LANDESNUMMER_UNBEKANNT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_BUFANR_UNBEKANNT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_LANDESNUMMER_BUFANR, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_PUFFER_ZUGRIFFSKONFLIKT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_PUFFER_UEBERLAUF, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_DATENARTVERSION_UNBEKANNT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_DATENARTVERSION_XML_INKONSISTENT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_COMMONDATA_NICHT_VERFUEGBAR, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_LOG_EXCEPTION, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_TRANSPORTSCHLUESSEL_NICHT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_OEFFENTLICHER_SCHLUESSEL_UNGUELTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_TRANSPORTSCHLUESSEL_TYP_FALSCH, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_PUFFER_UNGLEICHER_INSTANZ, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_VORSATZ_UNGUELTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_DATEIZUGRIFF_VERWEIGERT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UNGUELTIGE_INSTANZ, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NICHT_INITIALISIERT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_MEHRFACHE_INITIALISIERUNG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_FEHLER_INITIALISIERUNG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UNKNOWN_PARAMETER_ERROR, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_CHECK_CORRUPTED_NDS, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_VERSCHLUESSELUNGS_PARAMETER_NICHT_ANGEGEBEN, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_SEND_FLAG_MEHR_ALS_EINES, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UNGUELTIGE_FLAG_KOMBINATION, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ERSTE_SEITE_DRUCK_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UNGUELTIGER_PARAMETER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_DRUCK_FUER_VERFAHREN_NICHT_ERLAUBT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_VERSAND_ART_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UNGUELTIGE_PARAMETER_VERSION, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_TRANSFERHANDLE, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_PLUGININITIALISIERUNG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_INKOMPATIBLE_VERSIONEN, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_VERSCHLUESSELUNGSVERFAHREN_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_MEHRFACHAUFRUFE_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UTI_COUNTRY_NOT_SUPPORTED, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_IBAN_FORMALER_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_IBAN_LAENDERCODE_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_IBAN_LANDESFORMAT_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_IBAN_PRUEFZIFFER_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_BIC_FORMALER_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_BIC_LAENDERCODE_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ZULASSUNGSNUMMER_ZU_LANG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_IDNUMMER_UNGUELTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NULL_PARAMETER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_UPDATE_NECESSARY, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_EINSTELLUNG_NAME_UNGUELTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_EINSTELLUNG_WERT_UNGUELTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ERR_DEKODIEREN, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_FUNKTION_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NUTZDATENTICKETS_NICHT_EINDEUTIG, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NUTZDATENHEADERVERSIONEN_UNEINHEITLICH, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_BUNDESLAENDER_UNEINHEITLICH, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_ZEITRAEUME_UNEINHEITLICH, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_NUTZDATENHEADER_EMPFAENGER_NICHT_KORREKT, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_COM_ERROR, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_RESEND)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_VORGANG_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_XML_THEADER, ERIC_ERROR_CATEGORY_SERVER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_PARAM, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_DATENTEILENDNOTFOUND, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_BEGINDATENLIEFERANT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_ENDDATENLIEFERANT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_BEGINTRANSPORTSCHLUESSEL, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_ENDTRANSPORTSCHLUESSEL, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_BEGINDATENGROESSE, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_ENDDATENGROESSE, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_SEND, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_RESEND)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_NOTENCRYPTED, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_PROXYCONNECT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_CONNECTSERVER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_NORESPONSE, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_RESEND)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_PROXYAUTH, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_SEND_INIT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_TIMEOUT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_RESEND)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_PROXYPORT_INVALID, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_OTHER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_XML_NHEADER, ERIC_ERROR_CATEGORY_SERVER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_XML_ENCODING, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_ENDSIGUSER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_XMLTAG_NICHT_GEFUNDEN, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_DATENTEILFEHLER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_ZERTIFIKATFEHLER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_KEINKONTO, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_IDNRNICHTEINDEUTIG, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_SERVERFEHLER, ERIC_ERROR_CATEGORY_SERVER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_KEINCLIENT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_CLIENTFEHLER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_FEHLENDEFELDER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_IDENTIFIKATIONABGEBROCHEN, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_NPABLOCKIERT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_ERROR_CREATE_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_INVALID_HANDLE, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_MAX_SESSION, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_BUSY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_OUT_OF_MEM, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_PSE_PATH, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_PIN_WRONG, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_PIN_LOCKED, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P7_READ, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P7_DECODE, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P7_RECIPIENT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P12_READ, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P12_DECODE, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P12_SIG_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P12_ENC_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P11_SIG_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P11_ENC_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_XML_PARSE, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_XML_SIG_ADD, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_XML_SIG_TAG, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_XML_SIG_SIGN, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_ENCODE_UNKNOWN, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_ENCODE_ERROR, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_XML_INIT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_ENCRYPT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_DECRYPT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P11_SLOT_EMPTY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_NO_SIG_ENC_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_LOAD_DLL, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_NO_SERVICE, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_ESICL_EXCEPTION, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_TOKEN_TYPE_MISMATCH, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P12_CREATE, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_VERIFY_CERT_CHAIN, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P11_ENGINE_LOADED, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_USER_CANCEL, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_ZERTIFIKAT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_SIGNATUR, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_NICHT_UNTERSTUETZTES_PSE_FORMAT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_PIN_BENOETIGT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_PIN_STAERKE_NICHT_AUSREICHEND, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_INTERN, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_ZERTIFIKATSPFAD_KEIN_VERZEICHNIS, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_ZERTIFIKATSDATEI_EXISTIERT_BEREITS, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_PIN_ENTHAELT_UNGUELTIGE_ZEICHEN, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_INVALID_PARAM_ABC, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_CORRUPTED, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_EIDKARTE_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_SLOT_EMPTY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_NO_APPLET, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_SESSION, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P11_NO_SIG_CERT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P11_INIT_FAILED, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P11_NO_ENC_CERT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P12_NO_SIG_CERT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_P12_NO_ENC_CERT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_ENC_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_NO_SIG_CERT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_NO_ENC_CERT, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_INIT_FAILED, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_SC_SIG_KEY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_FEHLER, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_DATEI_INKORREKT, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_PARSE_FEHLER, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_NDS_GENERIERUNG_FEHLGESCHLAGEN, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_MASTERDATENSERVICE_NICHT_VERFUEGBAR, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_IO_STEUERZEICHEN_IM_NDS, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_VERSIONSINFORMATIONEN_NICHT_GEFUNDEN, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_FALSCHES_VERFAHREN, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_MEHRFACHE_STEUERFAELLE, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_UNERWARTETE_ELEMENTE, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_FORMALE_FEHLER, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_FALSCHES_ENCODING, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_MEHRFACHE_NUTZDATEN_ELEMENTE, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_MEHRFACHE_NUTZDATENBLOCK_ELEMENTE, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_UNBEKANNTE_DATENART, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_UNTERSACHBEREICH_UNGUELTIG, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_ZU_VIELE_NUTZDATENBLOCK_ELEMENTE, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_STEUERZEICHEN_IM_TRANSFERHEADER, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_STEUERZEICHEN_IM_NUTZDATENHEADER, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_STEUERZEICHEN_IN_DEN_NUTZDATEN, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_SCHEMA_VALIDIERUNGSFEHLER, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_READER_UNBEKANNTE_XML_ENTITY, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_DATENTEILNOTFOUND, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_DATENTEILENDNOTFOUND, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_UEBERGABEPARAMETER_FEHLERHAFT, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_UNGUELTIGE_UTF8_SEQUENZ, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_IO_UNGUELTIGE_ZEICHEN_IN_PARAMETER, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_INTERNER_FEHLER, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_DRUCKVORLAGE_NICHT_GEFUNDEN, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_UNGUELTIGER_DATEI_PFAD, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_INITIALISIERUNG_FEHLERHAFT, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_AUSGABEZIEL_UNBEKANNT, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_ABBRUCH_DRUCKVORBEREITUNG, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_ABBRUCH_GENERIERUNG, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_STEUERFALL_NICHT_UNTERSTUETZT, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_PRINT_FUSSTEXT_ZU_LANG, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
@@ -1,432 +1,5492 @@
 #include "php_eric.h"
 
-ZEND_BEGIN_MODULE_GLOBALS(eric)
-    int errCode;
-ZEND_END_MODULE_GLOBALS(eric)
 ZEND_DECLARE_MODULE_GLOBALS(eric)
 
-static eric_druck_parameter_t eric_print_params;
-static eric_verschluesselungs_parameter_t eric_encryption_params;
-static int certRequiresPin;
+#ifdef ZTS
+#define ERIC_MULTITHREADING_DEFAULT "1"
+#else
+#define ERIC_MULTITHREADING_DEFAULT "0"
+#endif
+
+/* dispatch to the Mt api when the instance owns an EricInstanzHandle */
+#define ERIC_CALL(inst, fn, ...) \
+    ((inst)->handle != NULL ? pEricMt##fn((inst)->handle, __VA_ARGS__) : pEric##fn(__VA_ARGS__))
+#define ERIC_CALL0(inst, fn) \
+    ((inst)->handle != NULL ? pEricMt##fn((inst)->handle) : pEric##fn())
+
+typedef struct _eric_cert_cache_entry {
+    char *path;
+    dev_t dev;
+    ino_t ino;
+    time_t mtime;
+    off_t size;
+    EricZertifikatHandle handle;
+    uint32_t pinSupport;
+    zend_ulong lastUse;
+} eric_cert_cache_entry;
+
+/* iInfoPinSupport bits saying a pin is needed for signature, decryption or encryption */
+#define ERIC_PIN_REQUIRED_MASK 0x07
+
+/* pooled return buffers holding more than this are freed instead of kept */
+#define ERIC_BUFFER_POOL_MAX_KEEP (1024 * 1024)
+
+typedef struct _eric_instance {
+    EricInstanzHandle handle; /* NULL for the singlethreading api */
+    eric_cert_cache_entry *certCache;
+    zend_ulong certClock;
+    int certGeneration; /* eric_cert_generation its cache was last flushed for */
+    EricRueckgabepufferHandle *buffers;
+    int bufferCount;
+    int logGeneration; /* eric_log_generation the callback was last registered for */
+    int progressRegistered;
+    int versionSynced; /* reference caches were checked against its EricVersion */
+    int borrowers; /* session objects of the owning request using it */
+    uint32_t phaseId; /* phase currently running, 0 before the first callback */
+    double phaseStart;
+    double runStart;
+    eric_timings timings;
+    struct _eric_instance *next; /* pool free list */
+    struct _eric_instance *nextCreated;
+} eric_instance;
+
+static int eric_cert_cache_size = 0;
+static int eric_buffer_pool_size = 0;
+
+static eric_instance eric_st_instance;
+static int eric_mt_enabled = 0;
+static int eric_pool_size = 0;
+static int eric_pool_created = 0;
+static int eric_pool_failures = 0;
+static int eric_pool_failures_logged = 0;
+static int eric_cert_generation = 0; /* bumped by eric_cert_cache_flush(), pooled instances flush at checkout */
+static eric_instance *eric_pool_free = NULL;
+static eric_instance *eric_pool_all = NULL;
+static pthread_mutex_t eric_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t eric_pool_cond = PTHREAD_COND_INITIALIZER;
+
+#define ERIC_LOG_HANDLER_FILE 0
+#define ERIC_LOG_HANDLER_BUFFER 1
+#define ERIC_LOG_HANDLER_SYSLOG 2
+
+#define ERIC_LOG_CATEGORY_MAX 64
+#define ERIC_LOG_MESSAGE_MAX 512
+
+/* bounded mpmc ring, a slot is free for position p when seq == p and filled when seq == p + 1 */
+typedef struct _eric_log_slot {
+    size_t seq;
+    int level;
+    double time;
+    char category[ERIC_LOG_CATEGORY_MAX];
+    char message[ERIC_LOG_MESSAGE_MAX];
+} eric_log_slot;
+
+typedef struct _eric_log_ring {
+    eric_log_slot *slots;
+    size_t mask;
+    size_t head; /* next write position */
+    size_t tail; /* next read position */
+    zend_ulong dropped;
+} eric_log_ring;
+
+static eric_log_ring eric_log;
+static int eric_log_handler = ERIC_LOG_HANDLER_FILE;
+static int eric_log_level = ERIC_LOG_INFO;
+static int eric_log_generation = 0;
+static int eric_log_syslog_running = 0;
+static int eric_log_syslog_idle = 0; /* drain is about to block, the next entry wakes it */
+static int eric_log_syslog_fd = -1;  /* eventfd the drain blocks on */
+static pid_t eric_log_syslog_pid = 0; /* threads do not survive fork, every worker process starts its own */
+static pthread_t eric_log_syslog_thread;
+static pthread_mutex_t eric_log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+PHP_INI_BEGIN()
+    PHP_INI_ENTRY("eric.library_path", "libericapi.so", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.plugin_path", "", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.log_path", "/var/log/httpd", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.log_handler", "file", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.log_level", "2", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.log_buffer_size", "1024", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.cert_cache_size", "8", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.buffer_pool_size", "4", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.multithreading", ERIC_MULTITHREADING_DEFAULT, PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.instance_pool_size", "4", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.native_validators", "0", PHP_INI_ALL, NULL)
+    PHP_INI_ENTRY("eric.spool_dir", "", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.check_cache_size", "256", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.retry_attempts", "1", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.retry_backoff", "200", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.retry_backoff_max", "5000", PHP_INI_SYSTEM, NULL)
+    PHP_INI_ENTRY("eric.retry_resend", "0", PHP_INI_SYSTEM, NULL)
+PHP_INI_END()
+
+/* copied in MINIT, instances are also created on native worker threads without ini access */
+static char *eric_plugin_path_ini = NULL;
+static char *eric_log_path_ini = NULL;
+
+static const char *eric_plugin_path()
+{
+    const char *path = eric_plugin_path_ini;
+
+    if(path == NULL || *path == '\0') {
+        return getenv("ERICAPI_LIB_PATH"); /* NULL: eric looks next to libericapi */
+    }
+
+    return path;
+}
+
+/* expands %p (pid) and %i (pool instance) in eric.log_path and creates the directory */
+static const char *eric_log_path(char *buf, size_t size, int instanceNo)
+{
+    const char *tpl = eric_log_path_ini;
+    size_t len = 0;
+    char *c;
+
+    if(tpl == NULL || *tpl == '\0') {
+        return NULL; /* eric falls back to the os temp directory */
+    }
+
+    for(; *tpl != '\0' && len + 1 < size; tpl++) {
+        if(tpl[0] == '%' && (tpl[1] == 'p' || tpl[1] == 'i')) {
+            len += snprintf(buf + len, size - len, "%ld", tpl[1] == 'p' ? (long) getpid() : (long) instanceNo);
+            len = MIN(len, size - 1);
+            tpl++;
+            continue;
+        }
+        buf[len++] = *tpl;
+    }
+    buf[len] = '\0';
+
+    for(c = buf + 1; *c != '\0'; c++) {
+        if(*c == '/') {
+            *c = '\0';
+            mkdir(buf, 0750);
+            *c = '/';
+        }
+    }
+    mkdir(buf, 0750);
+
+    return buf;
+}
+
+/* called by eric on its own threads, must not block and must not call into eric */
+static void STDCALL eric_log_callback(const char *category, eric_log_level_t level, const char *message, void *data)
+{
+    eric_log_slot *slot;
+    struct timespec ts;
+    size_t pos;
+
+    if((int) level < __atomic_load_n(&eric_log_level, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    pos = __atomic_load_n(&eric_log.head, __ATOMIC_RELAXED);
+    for(;;) {
+        slot = &eric_log.slots[pos & eric_log.mask];
+        size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if(seq == pos) {
+            if(__atomic_compare_exchange_n(&eric_log.head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if(seq < pos) {
+            __atomic_fetch_add(&eric_log.dropped, 1, __ATOMIC_RELAXED); /* full, drain is lagging */
+
+            return;
+        } else {
+            pos = __atomic_load_n(&eric_log.head, __ATOMIC_RELAXED);
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    slot->level = level;
+    slot->time = ts.tv_sec + ts.tv_nsec / 1e9;
+    strlcpy(slot->category, category != NULL ? category : "", ERIC_LOG_CATEGORY_MAX);
+    strlcpy(slot->message, message != NULL ? message : "", ERIC_LOG_MESSAGE_MAX);
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    /* pairs with the fence in eric_log_syslog_worker, only a sleeping drain costs a syscall */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&eric_log_syslog_idle, __ATOMIC_RELAXED)
+        && __atomic_exchange_n(&eric_log_syslog_idle, 0, __ATOMIC_RELAXED)
+    ) {
+        uint64_t one = 1;
+
+        if(write(eric_log_syslog_fd, &one, sizeof(one)) < 0) {
+            /* counter overflow only, the fd stays readable */
+        }
+    }
+}
+
+/* takes the oldest entry into *out, 0 when the ring is empty */
+static int eric_log_pop(eric_log_slot *out)
+{
+    eric_log_slot *slot;
+    size_t pos = __atomic_load_n(&eric_log.tail, __ATOMIC_RELAXED);
+
+    for(;;) {
+        slot = &eric_log.slots[pos & eric_log.mask];
+        size_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if(seq == pos + 1) {
+            if(__atomic_compare_exchange_n(&eric_log.tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if(seq < pos + 1) {
+            return 0;
+        } else {
+            pos = __atomic_load_n(&eric_log.tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(out, slot, sizeof(eric_log_slot));
+    __atomic_store_n(&slot->seq, pos + eric_log.mask + 1, __ATOMIC_RELEASE);
+
+    return 1;
+}
+
+static void eric_log_to_syslog(eric_log_slot *entry)
+{
+    static const int priorities[] = {LOG_DEBUG, LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERR};
+
+    syslog(
+        priorities[MIN(MAX(entry->level, 0), 4)],
+        "eric %s: %s",
+        entry->category,
+        entry->message
+    );
+}
+
+static void *eric_log_syslog_worker(void *arg)
+{
+    eric_log_slot entry;
+    uint64_t wakeups;
+
+    while(__atomic_load_n(&eric_log_syslog_running, __ATOMIC_ACQUIRE)) {
+        if(eric_log_pop(&entry)) {
+            eric_log_to_syslog(&entry);
+            continue;
+        }
+
+        /* announce the sleep before the last look, a callback in between sees idle and wakes us */
+        __atomic_store_n(&eric_log_syslog_idle, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if(eric_log_pop(&entry)) {
+            __atomic_store_n(&eric_log_syslog_idle, 0, __ATOMIC_RELAXED);
+            eric_log_to_syslog(&entry);
+            continue;
+        }
+        if(read(eric_log_syslog_fd, &wakeups, sizeof(wakeups)) < 0 && errno != EINTR) {
+            break;
+        }
+    }
+
+    while(eric_log_pop(&entry)) {
+        eric_log_to_syslog(&entry);
+    }
+
+    return NULL;
+}
+
+/* a drain inherited through fork has no thread in this process, it is only forgotten */
+static void eric_log_syslog_stop()
+{
+    uint64_t one = 1;
+
+    if(!eric_log_syslog_running) {
+        return;
+    }
+    __atomic_store_n(&eric_log_syslog_running, 0, __ATOMIC_RELEASE);
+    if(eric_log_syslog_pid == getpid()) {
+        if(write(eric_log_syslog_fd, &one, sizeof(one)) < 0) {
+            /* counter overflow only, the drain wakes anyway */
+        }
+        pthread_join(eric_log_syslog_thread, NULL);
+    }
+}
+
+/* must hold eric_log_mutex; called from RINIT, so every forked worker process starts its own drain */
+static void eric_log_syslog_start()
+{
+    int fd;
+
+    if(eric_log_syslog_running && eric_log_syslog_pid == getpid()) {
+        return;
+    }
+    eric_log_syslog_stop();
+
+    /* callbacks may write to the fd at any time, so it stays open and an inherited one is replaced in place */
+    if(eric_log_syslog_pid != getpid()) {
+        fd = eventfd(0, EFD_CLOEXEC);
+        if(fd < 0) {
+            php_log_err("eric: cant start syslog log thread\n");
+
+            return;
+        }
+        if(eric_log_syslog_fd >= 0) {
+            dup2(fd, eric_log_syslog_fd);
+            fcntl(eric_log_syslog_fd, F_SETFD, FD_CLOEXEC);
+            close(fd);
+        } else {
+            eric_log_syslog_fd = fd;
+        }
+        __atomic_store_n(&eric_log_syslog_pid, getpid(), __ATOMIC_RELAXED);
+    }
+
+    eric_log_syslog_idle = 0;
+    eric_log_syslog_running = 1;
+    if(pthread_create(&eric_log_syslog_thread, NULL, eric_log_syslog_worker, NULL) != 0) {
+        php_log_err("eric: cant start syslog log thread\n");
+        eric_log_syslog_running = 0;
+    }
+}
+
+/* (re)registers the callback when eric_set_log_handler() changed the handler since the last call */
+static void eric_log_sync(eric_instance *inst)
+{
+    int generation = __atomic_load_n(&eric_log_generation, __ATOMIC_ACQUIRE);
+    int file = __atomic_load_n(&eric_log_handler, __ATOMIC_RELAXED) == ERIC_LOG_HANDLER_FILE;
+
+    if(inst->logGeneration == generation) {
+        return;
+    }
+    if(ERIC_CALL(inst, RegistriereLogCallback, file ? NULL : eric_log_callback, file, NULL) == ERIC_OK) {
+        inst->logGeneration = generation;
+    }
+}
+
+/* eric may crash on exit with a callback still registered */
+static void eric_log_unregister(eric_instance *inst)
+{
+    if(inst->logGeneration != 0) {
+        ERIC_CALL(inst, RegistriereLogCallback, NULL, 1, NULL);
+        inst->logGeneration = 0;
+    }
+}
+
+static double eric_monotonic()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* runs synchronously inside EricBearbeiteVorgang on the calling thread, only phase changes are timed */
+static void STDCALL eric_progress_callback(uint32_t id, uint32_t pos, uint32_t max, void *data)
+{
+    eric_instance *inst = data;
+    double now;
+
+    if(id == inst->phaseId || id < ERIC_FORTSCHRITTCALLBACK_ID_EINLESEN || id > ERIC_FORTSCHRITTCALLBACK_ID_DRUCKEN) {
+        return;
+    }
+
+    now = eric_monotonic();
+    if(inst->phaseId != 0) {
+        inst->timings.phases[inst->phaseId / 10 - 1] += now - inst->phaseStart;
+    }
+    inst->phaseId = id;
+    inst->phaseStart = now;
+}
+
+static void eric_progress_register(eric_instance *inst)
+{
+    if(!inst->progressRegistered
+        && ERIC_CALL(inst, RegistriereFortschrittCallback, eric_progress_callback, inst) == ERIC_OK
+    ) {
+        inst->progressRegistered = 1;
+    }
+}
+
+static void eric_timings_begin(eric_instance *inst)
+{
+    memset(&inst->timings, 0, sizeof(eric_timings));
+    inst->phaseId = 0;
+    inst->runStart = eric_monotonic();
+}
+
+static void eric_timings_end(eric_instance *inst, eric_timings *out)
+{
+    double now = eric_monotonic();
+
+    if(inst->phaseId != 0) {
+        inst->timings.phases[inst->phaseId / 10 - 1] += now - inst->phaseStart;
+        inst->phaseId = 0;
+    }
+    inst->timings.total = now - inst->runStart;
+    memcpy(out, &inst->timings, sizeof(eric_timings));
+}
+
+static void eric_timings_to_array(eric_timings *timings, zval *zv)
+{
+    array_init_size(zv, ERIC_PHASE_COUNT + 1);
+    add_assoc_double(zv, "read", timings->phases[0]);
+    add_assoc_double(zv, "prepare", timings->phases[1]);
+    add_assoc_double(zv, "validate", timings->phases[2]);
+    add_assoc_double(zv, "send", timings->phases[3]);
+    add_assoc_double(zv, "print", timings->phases[4]);
+    add_assoc_double(zv, "total", timings->total);
+}
+
+static void eric_cert_cache_drop(eric_instance *inst, eric_cert_cache_entry *entry)
+{
+    ERIC_CALL(inst, CloseHandleToCertificate, entry->handle);
+    pefree(entry->path, 1);
+    memset(entry, 0, sizeof(eric_cert_cache_entry));
+}
+
+static int eric_cert_cache_flush_all(eric_instance *inst)
+{
+    int i, flushed = 0;
+
+    if(inst->certCache == NULL) {
+        return 0;
+    }
+
+    for(i = 0; i < eric_cert_cache_size; i++) {
+        if(inst->certCache[i].path != NULL) {
+            eric_cert_cache_drop(inst, &inst->certCache[i]);
+            flushed++;
+        }
+    }
+
+    return flushed;
+}
+
+/* keystore handles are kept open across requests; a changed file (inode, mtime, size) is reopened */
+static int eric_cert_open(
+    eric_instance *inst,
+    const char *path,
+    EricZertifikatHandle *handle,
+    uint32_t *pinSupport,
+    int *cached
+) {
+    struct stat st;
+    eric_cert_cache_entry *slot = NULL;
+    int i, err;
+
+    *cached = 0;
+    if(inst->certCache == NULL || stat(path, &st) != 0) {
+        return ERIC_CALL(inst, GetHandleToCertificate, handle, pinSupport, path);
+    }
+
+    for(i = 0; i < eric_cert_cache_size; i++) {
+        eric_cert_cache_entry *entry = &inst->certCache[i];
+
+        if(entry->path == NULL) {
+            if(slot == NULL || slot->path != NULL) {
+                slot = entry;
+            }
+            continue;
+        }
+        if(strcmp(entry->path, path) == 0) {
+            if(entry->dev == st.st_dev
+                && entry->ino == st.st_ino
+                && entry->mtime == st.st_mtime
+                && entry->size == st.st_size
+            ) {
+                entry->lastUse = ++inst->certClock;
+                *handle = entry->handle;
+                *pinSupport = entry->pinSupport;
+                *cached = 1;
+
+                return ERIC_OK;
+            }
+            eric_cert_cache_drop(inst, entry); /* keystore replaced on disk */
+            slot = entry;
+            continue;
+        }
+        if(slot == NULL || (slot->path != NULL && entry->lastUse < slot->lastUse)) {
+            slot = entry;
+        }
+    }
+
+    err = ERIC_CALL(inst, GetHandleToCertificate, handle, pinSupport, path);
+    if(err != ERIC_OK) {
+        return err;
+    }
+
+    if(slot->path != NULL) {
+        eric_cert_cache_drop(inst, slot); /* lru */
+    }
+    slot->path = pestrdup(path, 1);
+    slot->dev = st.st_dev;
+    slot->ino = st.st_ino;
+    slot->mtime = st.st_mtime;
+    slot->size = st.st_size;
+    slot->handle = *handle;
+    slot->pinSupport = *pinSupport;
+    slot->lastUse = ++inst->certClock;
+    *cached = 1;
+
+    return ERIC_OK;
+}
+
+static void eric_cert_release(eric_instance *inst, EricZertifikatHandle handle, int cached)
+{
+    if(!cached) {
+        ERIC_CALL(inst, CloseHandleToCertificate, handle);
+    }
+}
+
+/* eric clears a buffer before writing, so handles are reused instead of created per call */
+static EricRueckgabepufferHandle eric_buffer_acquire(eric_instance *inst)
+{
+    if(inst->bufferCount > 0) {
+        return inst->buffers[--inst->bufferCount];
+    }
+
+    return ERIC_CALL0(inst, RueckgabepufferErzeugen);
+}
+
+static void eric_buffer_release(eric_instance *inst, EricRueckgabepufferHandle buf)
+{
+    if(buf == NULL) {
+        return;
+    }
+
+    if(inst->bufferCount < eric_buffer_pool_size
+        && ERIC_CALL(inst, RueckgabepufferLaenge, buf) <= ERIC_BUFFER_POOL_MAX_KEEP
+    ) {
+        inst->buffers[inst->bufferCount++] = buf;
+
+        return;
+    }
+
+    ERIC_CALL(inst, RueckgabepufferFreigeben, buf);
+}
+
+static void eric_buffer_pool_flush(eric_instance *inst)
+{
+    while(inst->bufferCount > 0) {
+        ERIC_CALL(inst, RueckgabepufferFreigeben, inst->buffers[--inst->bufferCount]);
+    }
+}
+
+static void eric_instance_init(eric_instance *inst, EricInstanzHandle handle)
+{
+    memset(inst, 0, sizeof(eric_instance));
+    inst->handle = handle;
+    if(eric_cert_cache_size > 0) {
+        inst->certCache = pecalloc(eric_cert_cache_size, sizeof(eric_cert_cache_entry), 1);
+    }
+    if(eric_buffer_pool_size > 0) {
+        inst->buffers = pecalloc(eric_buffer_pool_size, sizeof(EricRueckgabepufferHandle), 1);
+    }
+}
+
+static void eric_instance_destroy(eric_instance *inst)
+{
+    eric_cert_cache_flush_all(inst);
+    if(inst->certCache != NULL) {
+        pefree(inst->certCache, 1);
+        inst->certCache = NULL;
+    }
+    eric_buffer_pool_flush(inst);
+    if(inst->buffers != NULL) {
+        pefree(inst->buffers, 1);
+        inst->buffers = NULL;
+    }
+}
+
+/* without wait, NULL is returned while all eric.instance_pool_size instances are checked out */
+static eric_instance *eric_instance_acquire_ex(int wait)
+{
+    eric_instance *inst;
+    EricInstanzHandle handle;
+    char logPath[MAXPATHLEN];
+    int instanceNo, certGeneration;
+
+    if(!eric_mt_enabled) {
+        return &eric_st_instance;
+    }
+
+    pthread_mutex_lock(&eric_pool_mutex);
+    while(eric_pool_free == NULL && eric_pool_created >= eric_pool_size) {
+        if(!wait) {
+            pthread_mutex_unlock(&eric_pool_mutex);
+
+            return NULL;
+        }
+        pthread_cond_wait(&eric_pool_cond, &eric_pool_mutex);
+    }
+    if(eric_pool_free != NULL) {
+        certGeneration = eric_cert_generation;
+        inst = eric_pool_free;
+        eric_pool_free = inst->next;
+        pthread_mutex_unlock(&eric_pool_mutex);
+        if(inst->certGeneration != certGeneration) {
+            eric_cert_cache_flush_all(inst);
+            inst->certGeneration = certGeneration;
+        }
+        eric_log_sync(inst);
+        eric_progress_register(inst);
+
+        return inst;
+    }
+    instanceNo = eric_pool_created++;
+    certGeneration = eric_cert_generation;
+    pthread_mutex_unlock(&eric_pool_mutex);
+
+    handle = pEricMtInstanzErzeugen(
+        eric_plugin_path(),
+        eric_log_path(logPath, sizeof(logPath), instanceNo)
+    );
+    if(handle == NULL) {
+        pthread_mutex_lock(&eric_pool_mutex);
+        eric_pool_failures++; /* may run on a native thread, logged by the next request */
+        eric_pool_created--;
+        pthread_cond_signal(&eric_pool_cond);
+        pthread_mutex_unlock(&eric_pool_mutex);
+
+        return NULL;
+    }
+
+    inst = pemalloc(sizeof(eric_instance), 1);
+    eric_instance_init(inst, handle);
+    inst->certGeneration = certGeneration;
+    eric_log_sync(inst);
+    eric_progress_register(inst);
+
+    pthread_mutex_lock(&eric_pool_mutex);
+    inst->nextCreated = eric_pool_all;
+    eric_pool_all = inst;
+    pthread_mutex_unlock(&eric_pool_mutex);
+
+    return inst;
+}
+
+static eric_instance *eric_instance_acquire()
+{
+    return eric_instance_acquire_ex(1);
+}
+
+/* request thread only, php_log_err needs the request context */
+static void eric_instance_log_failures()
+{
+    char msg[128];
+    int failures;
+
+    pthread_mutex_lock(&eric_pool_mutex);
+    failures = eric_pool_failures - eric_pool_failures_logged;
+    eric_pool_failures_logged = eric_pool_failures;
+    pthread_mutex_unlock(&eric_pool_mutex);
+
+    if(failures > 0) {
+        snprintf(msg, sizeof(msg), "eric: EricMtInstanzErzeugen failed %d time(s)\n", failures);
+        php_log_err(msg);
+    }
+}
+
+static void eric_instance_release(eric_instance *inst)
+{
+    if(inst == NULL || inst->handle == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&eric_pool_mutex);
+    inst->next = eric_pool_free;
+    eric_pool_free = inst;
+    pthread_cond_signal(&eric_pool_cond);
+    pthread_mutex_unlock(&eric_pool_mutex);
+}
+
+/* one binary-safe copy out of the eric owned buffer, straight into the zend_string */
+static zend_string *eric_buffer_to_string_ex(eric_instance *inst, EricRueckgabepufferHandle buf, int persistent)
+{
+    return zend_string_init(
+        ERIC_CALL(inst, RueckgabepufferInhalt, buf),
+        ERIC_CALL(inst, RueckgabepufferLaenge, buf),
+        persistent
+    );
+}
+
+static zend_string *eric_buffer_to_string(eric_instance *inst, EricRueckgabepufferHandle buf)
+{
+    return eric_buffer_to_string_ex(inst, buf, 0);
+}
+
+#define ERIC_ERROR_CATEGORY_GLOBAL 0
+#define ERIC_ERROR_CATEGORY_TRANSFER 1
+#define ERIC_ERROR_CATEGORY_CRYPT 2
+#define ERIC_ERROR_CATEGORY_IO 3
+#define ERIC_ERROR_CATEGORY_PRINT 4
+#define ERIC_ERROR_CATEGORY_SERVER 5
+
+#define ERIC_ERROR_RETRY_NEVER 0
+#define ERIC_ERROR_RETRY_SAFE 1   /* failed before the data left */
+#define ERIC_ERROR_RETRY_RESEND 2 /* ELSTER may already have the data, see eric.retry_resend */
+
+typedef struct _eric_error_info {
+    int code;
+    const char *name;
+    int category;
+    int retry;
+} eric_error_info;
+
+static const char *eric_error_categories[] = {"global", "transfer", "crypt", "io", "print", "server"};
+
+/* every code of eric_fehlercodes.h, see eric_error_table.awk */
+static const eric_error_info eric_error_table[] = {
+#define ERIC_ERROR_ENTRY(code, category, retry) {code, #code, category, retry},
+#include "eric_error_table.h"
+#undef ERIC_ERROR_ENTRY
+};
+
+static HashTable eric_error_index; /* code => eric_error_info*, built in MINIT */
+static zend_class_entry *eric_error_ce;
+
+static const eric_error_info *eric_error_lookup(int code)
+{
+    return zend_hash_index_find_ptr(&eric_error_index, (zend_ulong) (uint32_t) code);
+}
+
+/* copied in MINIT, jobs also run on native worker threads */
+static int eric_retry_attempts = 1;
+static int eric_retry_backoff = 0;
+static int eric_retry_backoff_max = 0;
+static int eric_retry_resend = 0;
+
+static int eric_error_retryable(int code)
+{
+    const eric_error_info *info = eric_error_lookup(code);
+
+    return info != NULL
+        && (info->retry == ERIC_ERROR_RETRY_SAFE || (info->retry == ERIC_ERROR_RETRY_RESEND && eric_retry_resend));
+}
+
+/* full jitter: a random wait up to backoff * 2^(attempt - 1), capped */
+static void eric_retry_wait(int attempt, unsigned int *seed)
+{
+    double limit = eric_retry_backoff;
+    struct timespec ts;
+    long ms;
+
+    while(--attempt > 0 && limit < eric_retry_backoff_max) {
+        limit *= 2;
+    }
+    if(limit > eric_retry_backoff_max) {
+        limit = eric_retry_backoff_max;
+    }
+
+    ms = (long) (limit * rand_r(seed) / ((double) RAND_MAX + 1));
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (ms % 1000) * 1000000;
+    while(nanosleep(&ts, &ts) != 0 && errno == EINTR);
+}
+
+typedef struct _eric_tax_office_entry {
+    zend_string *xml;
+    HashTable *parsed;              /* built on the first $as_array lookup */
+} eric_tax_office_entry;
+
+typedef struct _eric_tax_office_cache {
+    pthread_mutex_t mutex;
+    zend_string *version;           /* EricVersion the entries were fetched with */
+    eric_tax_office_entry *countryNumbers;
+    HashTable offices;              /* finanzamtLandNummer => eric_tax_office_entry* */
+    zend_ulong hits;
+    zend_ulong misses;
+} eric_tax_office_cache;
+
+static eric_tax_office_cache eric_tax_offices;
+
+typedef struct _eric_retired_entry {
+    zend_refcounted *p;
+    zend_ulong epoch;               /* eric_epoch when it left its cache */
+} eric_retired_entry;
+
+static eric_retired_entry *eric_retired = NULL;
+static int eric_retired_count = 0;
+static zend_ulong eric_epoch = 1;   /* advanced by every retire */
+static HashTable eric_epoch_requests; /* eric_epoch at RINIT => running requests */
+static pthread_mutex_t eric_retired_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* immutable process-lifetime string, handed to requests without copying or refcounting */
+static zend_string *eric_persistent_string(const char *str, size_t len)
+{
+    zend_string *s = zend_string_init(str, len, 1);
+
+    zend_string_hash_val(s);
+    GC_SET_REFCOUNT(s, 1);
+    GC_TYPE_INFO(s) = GC_STRING | ((IS_STR_INTERNED | IS_STR_PERSISTENT | IS_STR_PERMANENT) << GC_FLAGS_SHIFT);
+
+    return s;
+}
+
+/* values and keys must be eric_persistent_string()s; requests separate on write */
+static void eric_persistent_array_freeze(HashTable *ht)
+{
+    HT_FLAGS(ht) |= HASH_FLAG_STATIC_KEYS;
+    GC_SET_REFCOUNT(ht, 2);
+#ifdef GC_NOT_COLLECTABLE
+    GC_TYPE_INFO(ht) = GC_ARRAY | ((IS_ARRAY_IMMUTABLE | IS_ARRAY_PERSISTENT | GC_NOT_COLLECTABLE) << GC_FLAGS_SHIFT);
+#else
+    GC_TYPE_INFO(ht) = GC_ARRAY | ((IS_ARRAY_IMMUTABLE | IS_ARRAY_PERSISTENT) << GC_FLAGS_SHIFT);
+#endif
+}
+
+static void eric_persistent_array_free(HashTable *ht)
+{
+    zend_string *key;
+    zval *value;
+
+    ZEND_HASH_FOREACH_STR_KEY_VAL(ht, key, value) {
+        if(key != NULL) {
+            pefree(key, 1);
+        }
+        pefree(Z_STR_P(value), 1);
+    } ZEND_HASH_FOREACH_END();
+
+    GC_TYPE_INFO(ht) = GC_ARRAY | (IS_ARRAY_PERSISTENT << GC_FLAGS_SHIFT);
+    zend_hash_destroy(ht);
+    pefree(ht, 1);
+}
+
+static void eric_return_persistent_array(zval *zv, HashTable *ht)
+{
+    ZVAL_ARR(zv, ht);
+    Z_TYPE_FLAGS_P(zv) = 0; /* not refcounted, like opcache immutable arrays */
+}
+
+/* invalidated strings/arrays may still be referenced by requests that started before, see eric_retired_reclaim() */
+static void eric_retire(zend_refcounted *p)
+{
+    if(p == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&eric_retired_mutex);
+    eric_retired = perealloc(
+        eric_retired,
+        (eric_retired_count + 1) * sizeof(eric_retired_entry),
+        1
+    );
+    eric_retired[eric_retired_count].p = p;
+    eric_retired[eric_retired_count++].epoch = eric_epoch++;
+    pthread_mutex_unlock(&eric_retired_mutex);
+}
+
+/* requests only reach values that were still cached when they started */
+static void eric_epoch_enter()
+{
+    zval *running, zv;
+
+    pthread_mutex_lock(&eric_retired_mutex);
+    ERIC_G(epoch) = eric_epoch;
+    running = zend_hash_index_find(&eric_epoch_requests, eric_epoch);
+    if(running != NULL) {
+        Z_LVAL_P(running)++;
+    } else {
+        ZVAL_LONG(&zv, 1);
+        zend_hash_index_add_new(&eric_epoch_requests, eric_epoch, &zv);
+    }
+    pthread_mutex_unlock(&eric_retired_mutex);
+}
+
+/* with force everything is freed, otherwise what the oldest running request cannot reference */
+static void eric_retired_reclaim(int force)
+{
+    zend_ulong oldest = ZEND_ULONG_MAX, epoch;
+    int i, kept = 0;
+
+    pthread_mutex_lock(&eric_retired_mutex);
+    if(!force) {
+        ZEND_HASH_FOREACH_NUM_KEY(&eric_epoch_requests, epoch) {
+            oldest = MIN(oldest, epoch);
+        } ZEND_HASH_FOREACH_END();
+    }
+    for(i = 0; i < eric_retired_count; i++) {
+        zend_refcounted *p = eric_retired[i].p;
+
+        if(eric_retired[i].epoch >= oldest) {
+            eric_retired[kept++] = eric_retired[i];
+        } else if(GC_TYPE(p) == IS_ARRAY) {
+            eric_persistent_array_free((HashTable *) p);
+        } else {
+            pefree(p, 1);
+        }
+    }
+    eric_retired_count = kept;
+    if(kept == 0 && eric_retired != NULL) {
+        pefree(eric_retired, 1);
+        eric_retired = NULL;
+    }
+    pthread_mutex_unlock(&eric_retired_mutex);
+}
+
+static void eric_epoch_leave()
+{
+    zval *running;
+
+    pthread_mutex_lock(&eric_retired_mutex);
+    running = zend_hash_index_find(&eric_epoch_requests, ERIC_G(epoch));
+    if(running != NULL && --Z_LVAL_P(running) == 0) {
+        zend_hash_index_del(&eric_epoch_requests, ERIC_G(epoch));
+    }
+    pthread_mutex_unlock(&eric_retired_mutex);
+
+    eric_retired_reclaim(0);
+}
+
+/* decodes the predefined xml entities eric emits */
+static zend_string *eric_xml_unescape(const char *s, size_t len, int persistent)
+{
+    static const struct { const char *entity; size_t len; char c; } entities[] = {
+        {"&amp;", 5, '&'}, {"&lt;", 4, '<'}, {"&gt;", 4, '>'}, {"&quot;", 6, '"'}, {"&apos;", 6, '\''}
+    };
+    zend_string *out = zend_string_alloc(len, persistent);
+    char *o = ZSTR_VAL(out);
+    size_t i = 0;
+    int e;
+
+    while(i < len) {
+        if(s[i] == '&') {
+            for(e = 0; e < 5; e++) {
+                if(len - i >= entities[e].len && memcmp(s + i, entities[e].entity, entities[e].len) == 0) {
+                    break;
+                }
+            }
+            if(e < 5) {
+                *o++ = entities[e].c;
+                i += entities[e].len;
+                continue;
+            }
+        }
+        *o++ = s[i++];
+    }
+    *o = '\0';
+    ZSTR_LEN(out) = o - ZSTR_VAL(out);
+
+    return out;
+}
+
+/* finds <tag>value</tag> in [pos, end), returns the position after the closing tag */
+static const char *eric_xml_element(
+    const char *pos,
+    const char *end,
+    const char *tag,
+    const char **value,
+    size_t *valueLen
+) {
+    char open[64], close[64];
+    size_t openLen, closeLen;
+    const char *start, *stop;
+
+    openLen = snprintf(open, sizeof(open), "<%s>", tag);
+    closeLen = snprintf(close, sizeof(close), "</%s>", tag);
+
+    start = php_memnstr(pos, open, openLen, end);
+    if(start == NULL) {
+        return NULL;
+    }
+    start += openLen;
+    stop = php_memnstr(start, close, closeLen, end);
+    if(stop == NULL) {
+        return NULL;
+    }
+
+    *value = start;
+    *valueLen = stop - start;
+
+    return stop + closeLen;
+}
+
+/* flat generated reference xml: <record><keyTag>k</keyTag><valueTag>v</valueTag></record>... */
+static HashTable *eric_parse_reference_xml(
+    zend_string *xml,
+    const char *record,
+    const char *keyTag,
+    const char *valueTag
+) {
+    HashTable *ht = pemalloc(sizeof(HashTable), 1);
+    const char *pos = ZSTR_VAL(xml), *end = ZSTR_VAL(xml) + ZSTR_LEN(xml);
+    const char *body, *key, *value;
+    size_t bodyLen, keyLen, valueLen;
+    zend_ulong idx;
+    zval zv;
+
+    zend_hash_init(ht, 64, NULL, NULL, 1);
+
+    while((pos = eric_xml_element(pos, end, record, &body, &bodyLen)) != NULL) {
+        if(eric_xml_element(body, body + bodyLen, keyTag, &key, &keyLen) == NULL
+            || eric_xml_element(body, body + bodyLen, valueTag, &value, &valueLen) == NULL
+        ) {
+            continue;
+        }
+
+        zend_string *decoded = eric_xml_unescape(value, valueLen, 0);
+        ZVAL_INTERNED_STR(&zv, eric_persistent_string(ZSTR_VAL(decoded), ZSTR_LEN(decoded)));
+        zend_string_release(decoded);
+
+        if(ZEND_HANDLE_NUMERIC_STR(key, keyLen, idx)) {
+            zend_hash_index_update(ht, idx, &zv);
+        } else {
+            zend_hash_update(ht, eric_persistent_string(key, keyLen), &zv);
+        }
+    }
+
+    eric_persistent_array_freeze(ht);
+
+    return ht;
+}
+
+/* persistent, instances may be synced off the request thread */
+static zend_string *eric_fetch_version(eric_instance *inst)
+{
+    zend_string *version = NULL;
+    EricRueckgabepufferHandle buf = eric_buffer_acquire(inst);
+
+    if(ERIC_CALL(inst, Version, buf) == ERIC_OK) {
+        version = eric_buffer_to_string_ex(inst, buf, 1);
+    }
+    eric_buffer_release(inst, buf);
+
+    return version;
+}
+
+static void eric_tax_office_entry_retire(eric_tax_office_entry *entry)
+{
+    eric_retire((zend_refcounted *) entry->xml);
+    eric_retire((zend_refcounted *) entry->parsed);
+    pefree(entry, 1);
+}
+
+static int eric_tax_office_cache_flush_locked()
+{
+    int flushed = zend_hash_num_elements(&eric_tax_offices.offices);
+    eric_tax_office_entry *entry;
+
+    ZEND_HASH_FOREACH_PTR(&eric_tax_offices.offices, entry) {
+        eric_tax_office_entry_retire(entry);
+    } ZEND_HASH_FOREACH_END();
+    zend_hash_clean(&eric_tax_offices.offices);
+
+    if(eric_tax_offices.countryNumbers != NULL) {
+        eric_tax_office_entry_retire(eric_tax_offices.countryNumbers);
+        eric_tax_offices.countryNumbers = NULL;
+        flushed++;
+    }
+
+    return flushed;
+}
+
+/* plugin updates change the reference data, so entries are bound to the EricVersion output */
+static void eric_tax_office_cache_sync_version(zend_string *version)
+{
+    pthread_mutex_lock(&eric_tax_offices.mutex);
+    if(eric_tax_offices.version == NULL || !zend_string_equals(eric_tax_offices.version, version)) {
+        eric_tax_office_cache_flush_locked();
+        if(eric_tax_offices.version != NULL) {
+            zend_string_release_ex(eric_tax_offices.version, 1);
+        }
+        eric_tax_offices.version = zend_string_init(ZSTR_VAL(version), ZSTR_LEN(version), 1);
+    }
+    pthread_mutex_unlock(&eric_tax_offices.mutex);
+}
+
+static eric_tax_office_entry *eric_tax_office_cache_find_locked(const char *countryNumber, size_t len)
+{
+    if(countryNumber == NULL) {
+        return eric_tax_offices.countryNumbers;
+    }
+
+    return zend_hash_str_find_ptr(&eric_tax_offices.offices, countryNumber, len);
+}
+
+/* must hold the cache mutex; sets the cached xml or parsed array on zv */
+static void eric_tax_office_entry_return(eric_tax_office_entry *entry, int countryNumbers, int asArray, zval *zv)
+{
+    if(!asArray) {
+        ZVAL_INTERNED_STR(zv, entry->xml);
+
+        return;
+    }
+
+    if(entry->parsed == NULL) {
+        entry->parsed = countryNumbers
+            ? eric_parse_reference_xml(entry->xml, "FinanzamtLand", "FinanzamtLandNummer", "Name")
+            : eric_parse_reference_xml(entry->xml, "Finanzamt", "BuFaNummer", "Name");
+    }
+    eric_return_persistent_array(zv, entry->parsed);
+}
+
+/* countryNumber NULL addresses the EricHoleFinanzamtLandNummern result */
+static int eric_tax_office_lookup(
+    eric_instance *inst,
+    const char *countryNumber,
+    size_t len,
+    int asArray,
+    zval *zv
+) {
+    eric_tax_office_entry *entry;
+    zend_string *xml;
+    int ret;
+
+    pthread_mutex_lock(&eric_tax_offices.mutex);
+    entry = eric_tax_office_cache_find_locked(countryNumber, len);
+    if(entry != NULL) {
+        eric_tax_offices.hits++;
+        eric_tax_office_entry_return(entry, countryNumber == NULL, asArray, zv);
+        pthread_mutex_unlock(&eric_tax_offices.mutex);
+
+        return ERIC_OK;
+    }
+    eric_tax_offices.misses++;
+    pthread_mutex_unlock(&eric_tax_offices.mutex);
+
+    EricRueckgabepufferHandle buf = eric_buffer_acquire(inst);
+    if(countryNumber == NULL) {
+        ret = ERIC_CALL(inst, HoleFinanzamtLandNummern, buf);
+    } else {
+        ret = ERIC_CALL(inst, HoleFinanzaemter, countryNumber, buf);
+    }
+    if(ret != ERIC_OK) {
+        eric_buffer_release(inst, buf);
+
+        return ret;
+    }
+
+    xml = eric_persistent_string(
+        ERIC_CALL(inst, RueckgabepufferInhalt, buf),
+        ERIC_CALL(inst, RueckgabepufferLaenge, buf)
+    );
+    eric_buffer_release(inst, buf);
+
+    pthread_mutex_lock(&eric_tax_offices.mutex);
+    entry = eric_tax_office_cache_find_locked(countryNumber, len);
+    if(entry == NULL) {
+        entry = pecalloc(1, sizeof(eric_tax_office_entry), 1);
+        entry->xml = xml;
+        if(countryNumber == NULL) {
+            eric_tax_offices.countryNumbers = entry;
+        } else {
+            zend_hash_str_update_ptr(&eric_tax_offices.offices, countryNumber, len, entry);
+        }
+    } else {
+        pefree(xml, 1); /* filled concurrently by another thread */
+    }
+    eric_tax_office_entry_return(entry, countryNumber == NULL, asArray, zv);
+    pthread_mutex_unlock(&eric_tax_offices.mutex);
+
+    return ERIC_OK;
+}
+
+typedef struct _eric_check_entry {
+    int err;
+    zend_string *text;              /* fehlertextPuffer, persistent */
+} eric_check_entry;
+
+/* EricCheckXML results keyed by md5(xml \0 datenartVersion \0 EricVersion hash), also flushed on version changes */
+typedef struct _eric_check_cache {
+    pthread_mutex_t mutex;
+    zend_string *version;
+    zend_ulong versionHash;
+    HashTable entries;              /* hex digest => eric_check_entry*, oldest first */
+    zend_ulong hits;
+    zend_ulong misses;
+} eric_check_cache;
+
+static eric_check_cache eric_checks;
+static int eric_check_cache_size = 0;
+
+static void eric_check_entry_free(eric_check_entry *entry)
+{
+    zend_string_release_ex(entry->text, 1);
+    pefree(entry, 1);
+}
+
+static int eric_check_cache_flush_locked()
+{
+    int flushed = zend_hash_num_elements(&eric_checks.entries);
+    eric_check_entry *entry;
+
+    ZEND_HASH_FOREACH_PTR(&eric_checks.entries, entry) {
+        eric_check_entry_free(entry);
+    } ZEND_HASH_FOREACH_END();
+    zend_hash_clean(&eric_checks.entries);
+
+    return flushed;
+}
+
+static void eric_check_cache_sync_version(zend_string *version)
+{
+    pthread_mutex_lock(&eric_checks.mutex);
+    if(eric_checks.version == NULL || !zend_string_equals(eric_checks.version, version)) {
+        eric_check_cache_flush_locked();
+        if(eric_checks.version != NULL) {
+            zend_string_release_ex(eric_checks.version, 1);
+        }
+        eric_checks.version = zend_string_init(ZSTR_VAL(version), ZSTR_LEN(version), 1);
+        eric_checks.versionHash = zend_string_hash_val(eric_checks.version);
+    }
+    pthread_mutex_unlock(&eric_checks.mutex);
+}
+
+static void eric_check_key(const char *xml, size_t xmlLength, const char *dataType, size_t dataTypeLength, char *key)
+{
+    PHP_MD5_CTX ctx;
+    unsigned char digest[16];
+    zend_ulong versionHash;
+
+    /* verdicts of an older library can never be hit, even before the flush catches up */
+    pthread_mutex_lock(&eric_checks.mutex);
+    versionHash = eric_checks.versionHash;
+    pthread_mutex_unlock(&eric_checks.mutex);
+
+    PHP_MD5Init(&ctx);
+    PHP_MD5Update(&ctx, xml, xmlLength);
+    PHP_MD5Update(&ctx, "", 1);
+    PHP_MD5Update(&ctx, dataType, dataTypeLength);
+    PHP_MD5Update(&ctx, "", 1);
+    PHP_MD5Update(&ctx, &versionHash, sizeof(versionHash));
+    PHP_MD5Final(digest, &ctx);
+    make_digest_ex(key, digest, 16);
+}
+
+/* cached entries are moved to the end, so the first one is the least recently used */
+static int eric_check_xml(
+    eric_instance *inst,
+    const char *xml,
+    size_t xmlLength,
+    const char *dataType,
+    size_t dataTypeLength,
+    int useCache,
+    zend_string **text
+) {
+    char key[33];
+    eric_check_entry *entry;
+    int err;
+
+    useCache = useCache && eric_check_cache_size > 0;
+    if(useCache) {
+        eric_check_key(xml, xmlLength, dataType, dataTypeLength, key);
+
+        pthread_mutex_lock(&eric_checks.mutex);
+        entry = zend_hash_str_find_ptr(&eric_checks.entries, key, 32);
+        if(entry != NULL) {
+            eric_checks.hits++;
+            zend_hash_str_del(&eric_checks.entries, key, 32);
+            zend_hash_str_add_ptr(&eric_checks.entries, key, 32, entry);
+            err = entry->err;
+            *text = zend_string_init(ZSTR_VAL(entry->text), ZSTR_LEN(entry->text), 0);
+            pthread_mutex_unlock(&eric_checks.mutex);
+
+            return err;
+        }
+        eric_checks.misses++;
+        pthread_mutex_unlock(&eric_checks.mutex);
+    }
+
+    EricRueckgabepufferHandle buf = eric_buffer_acquire(inst);
+    err = ERIC_CALL(inst, CheckXML, xml, dataType, buf);
+    *text = eric_buffer_to_string(inst, buf);
+    eric_buffer_release(inst, buf);
+
+    /* only schema and plausibility verdicts depend on the document alone */
+    if(!useCache || (err != ERIC_OK && err != ERIC_GLOBAL_PRUEF_FEHLER && err != ERIC_GLOBAL_HINWEISE)) {
+        return err;
+    }
+
+    pthread_mutex_lock(&eric_checks.mutex);
+    if(zend_hash_str_find_ptr(&eric_checks.entries, key, 32) == NULL) {
+        if(zend_hash_num_elements(&eric_checks.entries) >= (uint32_t) eric_check_cache_size) {
+            zend_string *oldestKey;
+            eric_check_entry *oldest;
+
+            ZEND_HASH_FOREACH_STR_KEY_PTR(&eric_checks.entries, oldestKey, oldest) {
+                zend_hash_del(&eric_checks.entries, oldestKey);
+                eric_check_entry_free(oldest);
+                break;
+            } ZEND_HASH_FOREACH_END();
+        }
+        entry = pemalloc(sizeof(eric_check_entry), 1);
+        entry->err = err;
+        entry->text = zend_string_init(ZSTR_VAL(*text), ZSTR_LEN(*text), 1);
+        zend_hash_str_add_ptr(&eric_checks.entries, key, 32, entry);
+    }
+    pthread_mutex_unlock(&eric_checks.mutex);
+
+    return err;
+}
+
+static void eric_error_info_to_array(const eric_error_info *info, zval *zv)
+{
+    array_init_size(zv, 5);
+    add_assoc_long(zv, "code", info->code);
+    add_assoc_string(zv, "name", (char *) info->name);
+    add_assoc_string(zv, "category", (char *) eric_error_categories[info->category]);
+    add_assoc_bool(zv, "retryable", info->retry == ERIC_ERROR_RETRY_SAFE);
+    add_assoc_bool(zv, "resend", info->retry == ERIC_ERROR_RETRY_RESEND);
+}
+
+/* error codes as EricError::<name without ERIC_>, categories as EricError::CATEGORY_* */
+static void eric_error_register_class()
+{
+    zend_class_entry ce;
+    size_t i;
+
+    INIT_CLASS_ENTRY(ce, "EricError", NULL);
+    eric_error_ce = zend_register_internal_class(&ce);
+    eric_error_ce->ce_flags |= ZEND_ACC_FINAL;
+
+    zend_hash_init(&eric_error_index, sizeof(eric_error_table) / sizeof(eric_error_info), NULL, NULL, 1);
+    for(i = 0; i < sizeof(eric_error_table) / sizeof(eric_error_info); i++) {
+        const eric_error_info *info = &eric_error_table[i];
+        const char *name = info->code == ERIC_OK ? "OK" : info->name + sizeof("ERIC_") - 1;
+
+        zend_hash_index_update_ptr(&eric_error_index, (zend_ulong) (uint32_t) info->code, (void *) info);
+        zend_declare_class_constant_long(eric_error_ce, name, strlen(name), info->code);
+    }
+
+    zend_declare_class_constant_string(eric_error_ce, "CATEGORY_GLOBAL", sizeof("CATEGORY_GLOBAL") - 1, "global");
+    zend_declare_class_constant_string(eric_error_ce, "CATEGORY_TRANSFER", sizeof("CATEGORY_TRANSFER") - 1, "transfer");
+    zend_declare_class_constant_string(eric_error_ce, "CATEGORY_CRYPT", sizeof("CATEGORY_CRYPT") - 1, "crypt");
+    zend_declare_class_constant_string(eric_error_ce, "CATEGORY_IO", sizeof("CATEGORY_IO") - 1, "io");
+    zend_declare_class_constant_string(eric_error_ce, "CATEGORY_PRINT", sizeof("CATEGORY_PRINT") - 1, "print");
+    zend_declare_class_constant_string(eric_error_ce, "CATEGORY_SERVER", sizeof("CATEGORY_SERVER") - 1, "server");
+}
+
+/* HoleFehlerText results per code of eric_error_table, handed out as interned strings */
+typedef struct _eric_error_text_cache {
+    pthread_mutex_t mutex;
+    zend_string *version;
+    HashTable texts;                /* code => eric_persistent_string */
+} eric_error_text_cache;
+
+static eric_error_text_cache eric_error_texts;
+
+static void eric_error_text_cache_sync_version(zend_string *version)
+{
+    zend_string *text;
+
+    pthread_mutex_lock(&eric_error_texts.mutex);
+    if(eric_error_texts.version == NULL || !zend_string_equals(eric_error_texts.version, version)) {
+        ZEND_HASH_FOREACH_PTR(&eric_error_texts.texts, text) {
+            eric_retire((zend_refcounted *) text);
+        } ZEND_HASH_FOREACH_END();
+        zend_hash_clean(&eric_error_texts.texts);
+        if(eric_error_texts.version != NULL) {
+            zend_string_release_ex(eric_error_texts.version, 1);
+        }
+        eric_error_texts.version = zend_string_init(ZSTR_VAL(version), ZSTR_LEN(version), 1);
+    }
+    pthread_mutex_unlock(&eric_error_texts.mutex);
+}
+
+static zend_string *eric_error_text_find(int code)
+{
+    zend_string *text;
+
+    pthread_mutex_lock(&eric_error_texts.mutex);
+    text = zend_hash_index_find_ptr(&eric_error_texts.texts, (zend_ulong) (uint32_t) code);
+    pthread_mutex_unlock(&eric_error_texts.mutex);
+
+    return text;
+}
+
+/* NULL if eric has no text for the code, only the first lookup of a known code calls into eric; never syncs the version, it also runs on worker threads */
+static zend_string *eric_error_text(eric_instance *inst, int code)
+{
+    zend_string *text = eric_error_text_find(code);
+    zend_string *found;
+    EricRueckgabepufferHandle buf;
+
+    if(text != NULL) {
+        return text;
+    }
+
+    buf = eric_buffer_acquire(inst);
+    if(ERIC_CALL(inst, HoleFehlerText, code, buf) != ERIC_OK) {
+        eric_buffer_release(inst, buf);
+
+        return NULL;
+    }
+    text = eric_persistent_string(
+        ERIC_CALL(inst, RueckgabepufferInhalt, buf),
+        ERIC_CALL(inst, RueckgabepufferLaenge, buf)
+    );
+    eric_buffer_release(inst, buf);
+
+    /* any int reaches eric_get_error(), so the table stays bounded by eric_fehlercodes.h */
+    if(eric_error_lookup(code) == NULL) {
+        eric_retire((zend_refcounted *) text);
+
+        return text;
+    }
+
+    pthread_mutex_lock(&eric_error_texts.mutex);
+    found = zend_hash_index_find_ptr(&eric_error_texts.texts, (zend_ulong) (uint32_t) code);
+    if(found == NULL) {
+        zend_hash_index_update_ptr(&eric_error_texts.texts, (zend_ulong) (uint32_t) code, text);
+    } else {
+        pefree(text, 1); /* filled concurrently by another thread */
+        text = found;
+    }
+    pthread_mutex_unlock(&eric_error_texts.mutex);
+
+    return text;
+}
+
+/* plugins are loaded per instance, so a new one may come with a different EricVersion */
+static void eric_reference_cache_sync(eric_instance *inst)
+{
+    zend_string *version = eric_fetch_version(inst);
+
+    if(version != NULL) {
+        eric_tax_office_cache_sync_version(version);
+        eric_check_cache_sync_version(version);
+        eric_error_text_cache_sync_version(version);
+        zend_string_release_ex(version, 1);
+    }
+    inst->versionSynced = 1;
+}
+
+/* lazily checks out an instance for the current request, released in RSHUTDOWN */
+static eric_instance *eric_request_instance()
+{
+    if(ERIC_G(instance) == NULL) {
+        ERIC_G(instance) = eric_instance_acquire();
+        eric_instance_log_failures();
+        if(ERIC_G(instance) == NULL) {
+            ERIC_G(errCode) = ERIC_GLOBAL_FEHLER_INITIALISIERUNG;
+        } else if(!ERIC_G(instance)->versionSynced) {
+            eric_reference_cache_sync(ERIC_G(instance));
+        }
+    }
+
+    return ERIC_G(instance);
+}
+
+/* the request instance goes back to the pool unless session objects still use it;
+   at RSHUTDOWN (final) the last of them gives it back instead */
+static void eric_request_instance_release(int final)
+{
+    eric_instance *inst = ERIC_G(instance);
+
+    if(!eric_mt_enabled || inst == NULL) {
+        return;
+    }
+    if(inst->borrowers > 0) {
+        if(final) {
+            ERIC_G(instance) = NULL;
+        }
+
+        return;
+    }
+    eric_instance_release(inst);
+    ERIC_G(instance) = NULL;
+}
+
+/* handles are bound to the instance, so session objects share the request instance;
+   taking a second one from the pool could block on ourselves with a small pool */
+static eric_instance *eric_borrow_instance()
+{
+    eric_instance *inst = eric_request_instance();
+
+    if(inst != NULL) {
+        inst->borrowers++;
+    }
+
+    return inst;
+}
+
+/* free_obj may run after RSHUTDOWN, then the instance is no longer the request's */
+static void eric_return_instance(eric_instance *inst)
+{
+    if(--inst->borrowers == 0 && inst != ERIC_G(instance)) {
+        eric_instance_release(inst);
+    }
+}
+
+#define ERIC_ANSWER_TICKET 0
+#define ERIC_ANSWER_TH_CODE 1
+#define ERIC_ANSWER_TH_TEXT 2
+#define ERIC_ANSWER_NDH 3
+#define ERIC_ANSWER_PARTS 4
+
+/* transferticket, transfer header code and text, nutzdaten header codes as xml */
+static int eric_server_answer(eric_instance *inst, const char *xml, zend_string **parts, int persistent)
+{
+    EricRueckgabepufferHandle bufs[ERIC_ANSWER_PARTS];
+    int i, err;
+
+    for(i = 0; i < ERIC_ANSWER_PARTS; i++) {
+        bufs[i] = eric_buffer_acquire(inst);
+    }
+    err = ERIC_CALL(inst, GetErrormessagesFromXMLAnswer, xml, bufs[0], bufs[1], bufs[2], bufs[3]);
+    for(i = 0; i < ERIC_ANSWER_PARTS; i++) {
+        parts[i] = err == ERIC_OK ? eric_buffer_to_string_ex(inst, bufs[i], persistent) : NULL;
+        eric_buffer_release(inst, bufs[i]);
+    }
+
+    return err;
+}
+
+static void eric_server_answer_free(zend_string **parts, int persistent)
+{
+    int i;
+
+    for(i = 0; i < ERIC_ANSWER_PARTS; i++) {
+        if(parts[i] != NULL) {
+            zend_string_release_ex(parts[i], persistent);
+            parts[i] = NULL;
+        }
+    }
+}
+
+/* ['transferticket','code','text','ndh' => [['code','text'], ...]] */
+static void eric_server_answer_to_array(zend_string **parts, zval *zv)
+{
+    const char *pos, *end, *body, *value;
+    size_t bodyLen, valueLen;
+    zval ndh, entry;
+
+    array_init_size(zv, 4);
+    add_assoc_stringl(zv, "transferticket", ZSTR_VAL(parts[ERIC_ANSWER_TICKET]), ZSTR_LEN(parts[ERIC_ANSWER_TICKET]));
+    add_assoc_long(zv, "code", ZEND_STRTOL(ZSTR_VAL(parts[ERIC_ANSWER_TH_CODE]), NULL, 10));
+    add_assoc_stringl(zv, "text", ZSTR_VAL(parts[ERIC_ANSWER_TH_TEXT]), ZSTR_LEN(parts[ERIC_ANSWER_TH_TEXT]));
+
+    array_init(&ndh);
+    pos = ZSTR_VAL(parts[ERIC_ANSWER_NDH]);
+    end = pos + ZSTR_LEN(parts[ERIC_ANSWER_NDH]);
+    while((pos = eric_xml_element(pos, end, "Fehler", &body, &bodyLen)) != NULL) {
+        array_init_size(&entry, 2);
+        if(eric_xml_element(body, body + bodyLen, "Code", &value, &valueLen) != NULL) {
+            add_assoc_long(&entry, "code", ZEND_STRTOL(value, NULL, 10));
+        } else {
+            add_assoc_null(&entry, "code");
+        }
+        if(eric_xml_element(body, body + bodyLen, "Meldung", &value, &valueLen) != NULL) {
+            add_assoc_str(&entry, "text", eric_xml_unescape(value, valueLen, 0));
+        } else {
+            add_assoc_null(&entry, "text");
+        }
+        add_next_index_zval(&ndh, &entry);
+    }
+    add_assoc_zval(zv, "ndh", &ndh);
+}
+
+/* one EricBearbeiteVorgang call; input is borrowed, results are owned by the caller */
+typedef struct _eric_job {
+    const char *dataType;
+    const char *xml;
+    uint32_t flags; /* ERIC_VALIDIERE | ERIC_SENDE | ERIC_DRUCKE | ERIC_PRUEFE_HINWEISE */
+    const char *certPath; /* NULL or empty: no authenticated send */
+    EricZertifikatHandle cert; /* already open on the job's instance, certPath is ignored */
+    uint32_t certPinSupport;
+    const char *pin;
+    const char *pdfName; /* ERIC_DRUCKE only */
+    int persistent; /* results are allocated with pemalloc for use outside the request thread */
+    int parseAnswer; /* run GetErrormessagesFromXMLAnswer on the server response */
+    int keepBuffers; /* results stay in returnBuffer/responseBuffer, released by the caller */
+
+    int err;
+    int attempts; /* BearbeiteVorgang calls, more than one after retried transfer errors */
+    zend_string *errorText; /* interned HoleFehlerText of err, NULL for ERIC_OK */
+    int answerErr; /* GetErrormessagesFromXMLAnswer result, -1 if it did not run */
+    zend_string *answer[ERIC_ANSWER_PARTS];
+    zend_string *returnXml;
+    zend_string *serverResponse;
+    EricRueckgabepufferHandle returnBuffer;
+    EricRueckgabepufferHandle responseBuffer;
+    eric_timings timings;
+} eric_job;
+
+static int eric_job_process(eric_instance *inst, eric_job *job)
+{
+    eric_verschluesselungs_parameter_t crypto;
+    eric_druck_parameter_t print;
+    EricRueckgabepufferHandle returnHandle;
+    EricRueckgabepufferHandle responseHandle;
+    uint32_t requiresPin = 0;
+    int certCached = 0;
+    unsigned int seed = 0;
+    int ownCert = job->cert == 0;
+    int withCert = (job->flags & ERIC_SENDE) && (!ownCert || (job->certPath != NULL && *job->certPath != '\0'));
+
+    job->answerErr = -1;
+    if(job->xml == NULL || job->dataType == NULL || job->flags == 0) {
+        return job->err = ERIC_GLOBAL_NULL_PARAMETER;
+    }
+
+    memset(&crypto, 0, sizeof(crypto));
+    crypto.version = 2;
+    crypto.pin = job->pin != NULL ? job->pin : "";
+
+    /* validation and printing never touch the certificate */
+    if(withCert && !ownCert) {
+        crypto.zertifikatHandle = job->cert;
+        if(*crypto.pin == '\0' && (job->certPinSupport & ERIC_PIN_REQUIRED_MASK) != 0) {
+            return job->err = ERIC_CRYPT_PIN_BENOETIGT;
+        }
+    } else if(withCert) {
+        if(eric_cert_open(inst, job->certPath, &crypto.zertifikatHandle, &requiresPin, &certCached) != ERIC_OK) {
+            return job->err = ERIC_CRYPT_ZERTIFIKAT;
+        }
+        if(*crypto.pin == '\0' && (requiresPin & ERIC_PIN_REQUIRED_MASK) != 0) {
+            eric_cert_release(inst, crypto.zertifikatHandle, certCached);
+
+            return job->err = ERIC_CRYPT_PIN_BENOETIGT;
+        }
+    }
+
+    memset(&print, 0, sizeof(print));
+    print.version = 2;
+    print.pdfName = job->pdfName != NULL ? job->pdfName : "eric_print.pdf";
+
+    returnHandle = eric_buffer_acquire(inst);
+    responseHandle = eric_buffer_acquire(inst);
+
+    /* eric cannot send without validating, so a retry runs the whole call again;
+       the certificate and both buffers stay in place, eric overwrites the buffers */
+    for(job->attempts = 1; ; job->attempts++) {
+        eric_timings_begin(inst);
+        job->err = ERIC_CALL(
+            inst,
+            BearbeiteVorgang,
+            job->xml,
+            job->dataType,
+            job->flags,
+            (job->flags & ERIC_DRUCKE) ? &print : NULL,
+            withCert ? &crypto : NULL,
+            NULL,
+            returnHandle,
+            responseHandle
+        );
+        eric_timings_end(inst, &job->timings);
+
+        if(job->err == ERIC_OK
+            || !(job->flags & ERIC_SENDE)
+            || job->attempts >= eric_retry_attempts
+            || !eric_error_retryable(job->err)
+        ) {
+            break;
+        }
+        if(seed == 0) {
+            seed = (unsigned int) (eric_monotonic() * 1000000) ^ (unsigned int) (uintptr_t) job;
+        }
+        eric_retry_wait(job->attempts, &seed);
+    }
+    if(withCert && ownCert) {
+        eric_cert_release(inst, crypto.zertifikatHandle, certCached);
+    }
+
+    /* parsed right away from the response buffer, before it is copied out or reused */
+    if(job->parseAnswer && ERIC_CALL(inst, RueckgabepufferLaenge, responseHandle) > 0) {
+        job->answerErr = eric_server_answer(
+            inst,
+            ERIC_CALL(inst, RueckgabepufferInhalt, responseHandle),
+            job->answer,
+            job->persistent
+        );
+    }
+
+    if(job->keepBuffers) {
+        job->returnBuffer = returnHandle;
+        job->responseBuffer = responseHandle;
+
+        return job->err;
+    }
+
+    job->returnXml = eric_buffer_to_string_ex(inst, returnHandle, job->persistent);
+    job->serverResponse = eric_buffer_to_string_ex(inst, responseHandle, job->persistent);
+    eric_buffer_release(inst, returnHandle);
+    eric_buffer_release(inst, responseHandle);
+
+    return job->err;
+}
+
+/* thread safe as long as inst is used by the calling thread only;
+   the whole error state ends up in the job, concurrent jobs never share ERIC_G(errCode) */
+static int eric_job_run(eric_instance *inst, eric_job *job)
+{
+    eric_job_process(inst, job);
+    job->errorText = job->err != ERIC_OK ? eric_error_text(inst, job->err) : NULL;
+
+    return job->err;
+}
+
+/* for request thread jobs, assigns the parsed answer or null and frees the parts */
+static void eric_job_assign_answer(eric_job *job, zval *serverAnswer)
+{
+    zval zv;
+
+    if(job->answerErr == ERIC_OK) {
+        eric_server_answer_to_array(job->answer, &zv);
+        ZEND_TRY_ASSIGN_REF_ARR(serverAnswer, Z_ARR(zv));
+    } else {
+        ZEND_TRY_ASSIGN_REF_NULL(serverAnswer);
+    }
+    eric_server_answer_free(job->answer, job->persistent);
+}
+
+/* eventfd shared by a request and its pending futures, whoever drops the last reference closes it */
+typedef struct _eric_async_notifier {
+    int fd;
+    int refcount;
+} eric_async_notifier;
+
+typedef struct _eric_future {
+    eric_job job;
+    char *strings[5]; /* persistent copies, the request may be gone before the job ran */
+    int done;
+    int refcount; /* the resource and the queue */
+    eric_async_notifier *notifier;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    struct _eric_future *next; /* queue */
+} eric_future;
+
+#define ERIC_ASYNC_THREADS_MAX 64
+
+static int le_eric_future;
+static eric_future *eric_async_head = NULL;
+static eric_future *eric_async_tail = NULL;
+static int eric_async_stopping = 0;
+static int eric_async_thread_count = 0;
+static pthread_t eric_async_threads[ERIC_ASYNC_THREADS_MAX];
+static pthread_mutex_t eric_async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t eric_async_cond = PTHREAD_COND_INITIALIZER;
+
+static eric_async_notifier *eric_async_notifier_get()
+{
+    if(ERIC_G(notifier) == NULL) {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if(fd < 0) {
+            return NULL;
+        }
+        ERIC_G(notifier) = pemalloc(sizeof(eric_async_notifier), 1);
+        ERIC_G(notifier)->fd = fd;
+        ERIC_G(notifier)->refcount = 1;
+    }
+
+    return ERIC_G(notifier);
+}
+
+static void eric_async_notifier_release(eric_async_notifier *notifier)
+{
+    if(notifier != NULL && __atomic_sub_fetch(&notifier->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        close(notifier->fd);
+        pefree(notifier, 1);
+    }
+}
+
+static void eric_future_release(eric_future *future)
+{
+    int i;
+
+    if(__atomic_sub_fetch(&future->refcount, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    for(i = 0; i < 5; i++) {
+        if(future->strings[i] != NULL) {
+            pefree(future->strings[i], 1);
+        }
+    }
+    if(future->job.returnXml != NULL) {
+        zend_string_release_ex(future->job.returnXml, 1);
+    }
+    if(future->job.serverResponse != NULL) {
+        zend_string_release_ex(future->job.serverResponse, 1);
+    }
+    eric_server_answer_free(future->job.answer, 1);
+    eric_async_notifier_release(future->notifier);
+    pthread_cond_destroy(&future->cond);
+    pthread_mutex_destroy(&future->mutex);
+    pefree(future, 1);
+}
+
+static void eric_future_complete(eric_future *future)
+{
+    uint64_t one = 1;
+
+    pthread_mutex_lock(&future->mutex);
+    future->done = 1;
+    pthread_cond_broadcast(&future->cond);
+    pthread_mutex_unlock(&future->mutex);
+
+    if(future->notifier != NULL && write(future->notifier->fd, &one, sizeof(one)) < 0) {
+        /* counter overflow only, the fd stays readable */
+    }
+}
+
+static void eric_future_dtor(zend_resource *res)
+{
+    eric_future_release((eric_future *) res->ptr);
+}
+
+static void *eric_async_worker(void *arg)
+{
+    eric_future *future;
+    eric_instance *inst;
+
+    for(;;) {
+        pthread_mutex_lock(&eric_async_mutex);
+        while(eric_async_head == NULL && !eric_async_stopping) {
+            pthread_cond_wait(&eric_async_cond, &eric_async_mutex);
+        }
+        if(eric_async_head == NULL) {
+            pthread_mutex_unlock(&eric_async_mutex);
+
+            return NULL;
+        }
+        future = eric_async_head;
+        eric_async_head = future->next;
+        if(eric_async_head == NULL) {
+            eric_async_tail = NULL;
+        }
+        pthread_mutex_unlock(&eric_async_mutex);
+
+        inst = eric_instance_acquire();
+        if(inst != NULL) {
+            eric_job_run(inst, &future->job);
+            eric_instance_release(inst);
+        } else {
+            future->job.err = ERIC_GLOBAL_FEHLER_INITIALISIERUNG;
+        }
+        eric_future_complete(future);
+        eric_future_release(future);
+    }
+}
+
+/* threads are started on first use and live until MSHUTDOWN */
+static int eric_async_submit(eric_future *future)
+{
+    int wanted = MIN(eric_pool_size, ERIC_ASYNC_THREADS_MAX);
+
+    pthread_mutex_lock(&eric_async_mutex);
+    while(eric_async_thread_count < wanted
+        && pthread_create(&eric_async_threads[eric_async_thread_count], NULL, eric_async_worker, NULL) == 0
+    ) {
+        eric_async_thread_count++;
+    }
+    if(eric_async_thread_count == 0) {
+        pthread_mutex_unlock(&eric_async_mutex);
+
+        return FAILURE;
+    }
+
+    future->next = NULL;
+    if(eric_async_tail != NULL) {
+        eric_async_tail->next = future;
+    } else {
+        eric_async_head = future;
+    }
+    eric_async_tail = future;
+    pthread_cond_signal(&eric_async_cond);
+    pthread_mutex_unlock(&eric_async_mutex);
+
+    return SUCCESS;
+}
+
+static void eric_async_shutdown()
+{
+    int i;
+
+    pthread_mutex_lock(&eric_async_mutex);
+    eric_async_stopping = 1;
+    pthread_cond_broadcast(&eric_async_cond);
+    pthread_mutex_unlock(&eric_async_mutex);
+
+    for(i = 0; i < eric_async_thread_count; i++) {
+        pthread_join(eric_async_threads[i], NULL); /* queued jobs are finished first */
+    }
+    eric_async_thread_count = 0;
+}
+
+static char *eric_future_string(eric_future *future, int slot, const char *str)
+{
+    if(str == NULL) {
+        return NULL;
+    }
+
+    return future->strings[slot] = pestrdup(str, 1);
+}
+
+/* spool journal: records appended by eric_enqueue(), drained by eric_spool_run() */
+#define ERIC_SPOOL_MAGIC "ESP2"
+#define ERIC_SPOOL_ID_LENGTH 32
+#define ERIC_SPOOL_READ_MAX 256 /* records per drain round */
+#define ERIC_SPOOL_READ_BYTES (64 * 1024 * 1024)
+
+typedef struct _eric_spool_header {
+    char magic[4];
+    uint32_t flags;
+    char id[ERIC_SPOOL_ID_LENGTH];
+    uint32_t dataTypeLength;
+    uint32_t xmlLength;
+    uint32_t certLength;
+} eric_spool_header;
+
+/* follows dataType, xml and cert; a record only counts once its trailer matches */
+typedef struct _eric_spool_trailer {
+    uint32_t length;                /* header and payload */
+    uint32_t crc;                   /* crc32 of header and payload */
+} eric_spool_trailer;
+
+typedef struct _eric_spool_result_header {
+    int32_t code;
+    uint32_t returnXmlLength;
+    uint32_t serverResponseLength;
+    uint32_t attempts;
+    eric_timings timings;
+} eric_spool_result_header;
+
+/* group commit: one fdatasync covers every record written before it started */
+static int eric_spool_fd = -1;
+static char *eric_spool_fd_dir = NULL;
+static zend_ulong eric_spool_written = 0;
+static zend_ulong eric_spool_synced = 0;
+static int eric_spool_syncing = 0;
+static uint32_t eric_spool_counter = 0;
+static pthread_mutex_t eric_spool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t eric_spool_cond = PTHREAD_COND_INITIALIZER;
+
+static const char *eric_spool_dir()
+{
+    const char *dir = INI_STR("eric.spool_dir");
+
+    return dir != NULL && *dir != '\0' ? dir : NULL;
+}
+
+static uint32_t eric_spool_crc32(uint32_t crc, const char *data, size_t len)
+{
+    while(len-- > 0) {
+        CRC32(crc, (unsigned char) *data++);
+    }
+
+    return crc;
+}
+
+static int eric_spool_write_all(int fd, const char *buf, size_t len)
+{
+    while(len > 0) {
+        ssize_t n = write(fd, buf, len);
+
+        if(n < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+
+            return FAILURE;
+        }
+        buf += n;
+        len -= n;
+    }
+
+    return SUCCESS;
+}
+
+static int eric_spool_append(const char *dir, const char *record, size_t len)
+{
+    char path[MAXPATHLEN];
+    zend_ulong seq, target;
+    struct stat st;
+    int ret;
+
+    pthread_mutex_lock(&eric_spool_mutex);
+    if(eric_spool_fd < 0 || eric_spool_fd_dir == NULL || strcmp(eric_spool_fd_dir, dir) != 0) {
+        if(eric_spool_fd >= 0) {
+            close(eric_spool_fd);
+            pefree(eric_spool_fd_dir, 1);
+        }
+        mkdir(dir, 0700);
+        snprintf(path, sizeof(path), "%s/journal", dir);
+        eric_spool_fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+        eric_spool_fd_dir = eric_spool_fd >= 0 ? pestrdup(dir, 1) : NULL;
+        if(eric_spool_fd < 0) {
+            pthread_mutex_unlock(&eric_spool_mutex);
+
+            return FAILURE;
+        }
+    }
+
+    /* exclusive, so a record written in several parts can be cut off again before anyone appends behind it */
+    flock(eric_spool_fd, LOCK_EX);
+    ret = FAILURE;
+    if(fstat(eric_spool_fd, &st) == 0) {
+        ret = eric_spool_write_all(eric_spool_fd, record, len);
+        if(ret != SUCCESS && ftruncate(eric_spool_fd, st.st_size) != 0) {
+            php_log_err("eric: cant remove a partial spool record\n"); /* eric_spool_load() skips it by its trailer */
+        }
+    }
+    flock(eric_spool_fd, LOCK_UN);
+    if(ret != SUCCESS) {
+        pthread_mutex_unlock(&eric_spool_mutex);
+
+        return FAILURE;
+    }
+
+    seq = ++eric_spool_written;
+    while(eric_spool_synced < seq) {
+        if(eric_spool_syncing) {
+            pthread_cond_wait(&eric_spool_cond, &eric_spool_mutex);
+            continue;
+        }
+        eric_spool_syncing = 1;
+        target = eric_spool_written;
+        int fd = eric_spool_fd;
+        pthread_mutex_unlock(&eric_spool_mutex);
+
+        ret = fdatasync(fd);
+
+        pthread_mutex_lock(&eric_spool_mutex);
+        eric_spool_syncing = 0;
+        if(ret == 0) {
+            eric_spool_synced = target;
+        }
+        pthread_cond_broadcast(&eric_spool_cond);
+        if(ret != 0) {
+            pthread_mutex_unlock(&eric_spool_mutex);
+
+            return FAILURE;
+        }
+    }
+    pthread_mutex_unlock(&eric_spool_mutex);
+
+    return SUCCESS;
+}
+
+static void eric_spool_close()
+{
+    if(eric_spool_fd >= 0) {
+        close(eric_spool_fd);
+        pefree(eric_spool_fd_dir, 1);
+        eric_spool_fd = -1;
+        eric_spool_fd_dir = NULL;
+    }
+}
+
+/* writes to a stream resource or calls a callable with each chunk */
+static int eric_sink_write(zval *sink, const char *data, size_t len)
+{
+    php_stream *stream;
+
+    if(Z_TYPE_P(sink) == IS_RESOURCE) {
+        php_stream_from_zval_no_verify(stream, sink);
+        if(stream == NULL) {
+            return FAILURE;
+        }
+
+        return php_stream_write(stream, data, len) == len ? SUCCESS : FAILURE;
+    }
+
+    zval arg, retval;
+    int ret;
+
+    ZVAL_STRINGL(&arg, data, len);
+    ret = call_user_function(NULL, NULL, sink, &retval, 1, &arg);
+    zval_ptr_dtor(&arg);
+    if(ret == SUCCESS) {
+        zval_ptr_dtor(&retval);
+    }
+
+    return ret == SUCCESS && EG(exception) == NULL ? SUCCESS : FAILURE;
+}
+
+/* strings never name a callable sink, server data must not reach a function like "system" by its name */
+static int eric_sink_valid(zval *sink)
+{
+    return Z_TYPE_P(sink) == IS_RESOURCE || (Z_TYPE_P(sink) != IS_STRING && zend_is_callable(sink, 0, NULL));
+}
+
+#define ERIC_RETRIEVAL_CHUNK (1024 * 1024)
+
+/* Datenabholung session: transfer handle, certificate and instance stay open across the steps */
+typedef struct _eric_retrieval {
+    eric_instance *inst;
+    EricTransferHandle transferHandle;
+    EricZertifikatHandle cert;      /* owned, not from the instance cache that may close it meanwhile */
+    char *pin;
+    zend_object std;
+} eric_retrieval;
+
+static zend_class_entry *eric_retrieval_ce;
+static zend_object_handlers eric_retrieval_handlers;
+
+static eric_retrieval *eric_retrieval_from_obj(zend_object *obj)
+{
+    return (eric_retrieval *) ((char *) obj - XtOffsetOf(eric_retrieval, std));
+}
+
+static void eric_retrieval_close(eric_retrieval *session)
+{
+    if(session->inst == NULL) {
+        return;
+    }
+    if(session->cert != 0) {
+        ERIC_CALL(session->inst, CloseHandleToCertificate, session->cert);
+        session->cert = 0;
+    }
+    if(session->pin != NULL) {
+        efree(session->pin);
+        session->pin = NULL;
+    }
+    eric_return_instance(session->inst);
+    session->inst = NULL;
+}
+
+static zend_object *eric_retrieval_create(zend_class_entry *ce)
+{
+    eric_retrieval *session = zend_object_alloc(sizeof(eric_retrieval), ce);
+
+    zend_object_std_init(&session->std, ce);
+    object_properties_init(&session->std, ce);
+    session->std.handlers = &eric_retrieval_handlers;
+
+    return &session->std;
+}
+
+static void eric_retrieval_free(zend_object *obj)
+{
+    eric_retrieval_close(eric_retrieval_from_obj(obj));
+    zend_object_std_dtor(obj);
+}
+
+static eric_retrieval *eric_retrieval_fetch(zval *zv)
+{
+    eric_retrieval *session = eric_retrieval_from_obj(Z_OBJ_P(zv));
+
+    if(session->inst == NULL) {
+        zend_throw_error(NULL, "EricRetrieval is closed");
+
+        return NULL;
+    }
+
+    return session;
+}
+
+PHP_METHOD(EricRetrieval, __construct)
+{
+    char *certPath;
+    size_t certLength;
+    char *pin = "";
+    size_t pinLength = 0;
+    uint32_t requiresPin = 0;
+    eric_retrieval *session = eric_retrieval_from_obj(Z_OBJ_P(ZEND_THIS));
+
+    ZEND_PARSE_PARAMETERS_START(1,2)
+        Z_PARAM_STRING(certPath, certLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STRING(pin, pinLength)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        zend_throw_exception(zend_ce_exception, "ericapilib not loaded", -1);
+        RETURN_THROWS();
+    }
+
+    eric_retrieval_close(session);
+    session->inst = eric_borrow_instance();
+    if(session->inst == NULL) {
+        zend_throw_exception(zend_ce_exception, "no eric instance available", ERIC_G(errCode));
+        RETURN_THROWS();
+    }
+
+    if(ERIC_CALL(session->inst, GetHandleToCertificate, &session->cert, &requiresPin, certPath) != ERIC_OK) {
+        session->cert = 0;
+        eric_retrieval_close(session);
+        ERIC_G(errCode) = ERIC_CRYPT_ZERTIFIKAT;
+        zend_throw_exception(zend_ce_exception, "certificate could not be opened", ERIC_G(errCode));
+        RETURN_THROWS();
+    }
+    if(pinLength == 0 && (requiresPin & ERIC_PIN_REQUIRED_MASK) != 0) {
+        eric_retrieval_close(session);
+        ERIC_G(errCode) = ERIC_CRYPT_PIN_BENOETIGT;
+        zend_throw_exception(zend_ce_exception, "certificate requires a pin", ERIC_G(errCode));
+        RETURN_THROWS();
+    }
+    session->pin = estrndup(pin, pinLength);
+    session->transferHandle = 0;
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_retrieval_construct, 0)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+    ZEND_ARG_INFO(0, eric_certificate_pin)
+ZEND_END_ARG_INFO()
+
+/* one Anforderung/Abholung/Quittierung step, bundled through the session's transfer handle */
+PHP_METHOD(EricRetrieval, send)
+{
+    zval *serverResponse;
+    char *dataType;
+    size_t dataTypeLength;
+    char *xml;
+    size_t xmlLength;
+    zend_long flags = ERIC_VALIDIERE | ERIC_SENDE;
+    eric_verschluesselungs_parameter_t crypto;
+    eric_retrieval *session;
+
+    ZEND_PARSE_PARAMETERS_START(3,4)
+        Z_PARAM_ZVAL(serverResponse)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_STRING(xml, xmlLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(flags)
+    ZEND_PARSE_PARAMETERS_END();
+
+    session = eric_retrieval_fetch(ZEND_THIS);
+    if(session == NULL) {
+        RETURN_THROWS();
+    }
+
+    memset(&crypto, 0, sizeof(crypto));
+    crypto.version = 2;
+    crypto.zertifikatHandle = session->cert;
+    crypto.pin = session->pin;
+
+    EricRueckgabepufferHandle returnHandle = eric_buffer_acquire(session->inst);
+    EricRueckgabepufferHandle responseHandle = eric_buffer_acquire(session->inst);
+
+    eric_timings_begin(session->inst);
+    int err = ERIC_CALL(
+        session->inst,
+        BearbeiteVorgang,
+        xml,
+        dataType,
+        (uint32_t) flags,
+        NULL,
+        &crypto,
+        &session->transferHandle,
+        returnHandle,
+        responseHandle
+    );
+    eric_timings_end(session->inst, &ERIC_G(lastTimings));
+    ERIC_G(errCode) = err;
+
+    ZEND_TRY_ASSIGN_REF_STR(serverResponse, eric_buffer_to_string(session->inst, responseHandle));
+    eric_buffer_release(session->inst, responseHandle);
+
+    if(err == ERIC_OK) {
+        RETVAL_STR(eric_buffer_to_string(session->inst, returnHandle));
+        eric_buffer_release(session->inst, returnHandle);
+
+        return;
+    }
+    eric_buffer_release(session->inst, returnHandle);
+
+    RETURN_FALSE;
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_retrieval_send, 1)
+    ZEND_ARG_INFO(1, server_response)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, flags)
+ZEND_END_ARG_INFO()
+
+/* decodes one base64 Datenpaket; with a sink the result is passed on in chunks instead of returned */
+static int eric_retrieval_decode(eric_retrieval *session, const char *base64, zval *sink, zend_long chunkSize, zval *out)
+{
+    EricRueckgabepufferHandle buf = eric_buffer_acquire(session->inst);
+    const char *data;
+    size_t len, off;
+    int err;
+
+    err = ERIC_CALL(session->inst, DekodiereDaten, session->cert, session->pin, base64, buf);
+    if(err == ERIC_OK) {
+        data = ERIC_CALL(session->inst, RueckgabepufferInhalt, buf);
+        len = ERIC_CALL(session->inst, RueckgabepufferLaenge, buf);
+        if(sink == NULL) {
+            ZVAL_STRINGL(out, data, len);
+        } else {
+            for(off = 0; off < len; off += chunkSize) {
+                if(eric_sink_write(sink, data + off, MIN((size_t) chunkSize, len - off)) != SUCCESS) {
+                    err = ERIC_IO_FEHLER;
+                    break;
+                }
+            }
+            ZVAL_LONG(out, len);
+        }
+    }
+    eric_buffer_release(session->inst, buf);
+
+    return err;
+}
+
+PHP_METHOD(EricRetrieval, decode)
+{
+    char *base64;
+    size_t base64Length;
+    zval *sink = NULL;
+    zend_long chunkSize = ERIC_RETRIEVAL_CHUNK;
+    eric_retrieval *session;
+
+    ZEND_PARSE_PARAMETERS_START(1,3)
+        Z_PARAM_STRING(base64, base64Length)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ZVAL_OR_NULL(sink)
+        Z_PARAM_LONG(chunkSize)
+    ZEND_PARSE_PARAMETERS_END();
+
+    session = eric_retrieval_fetch(ZEND_THIS);
+    if(session == NULL) {
+        RETURN_THROWS();
+    }
+    if(chunkSize < 1 || (sink != NULL && !eric_sink_valid(sink))) {
+        zend_argument_value_error(2, "must be a stream or callable with a positive chunk size");
+        RETURN_THROWS();
+    }
+
+    ERIC_G(errCode) = eric_retrieval_decode(session, base64, sink, chunkSize, return_value);
+    if(ERIC_G(errCode) != ERIC_OK) {
+        zval_ptr_dtor(return_value);
+        RETURN_FALSE;
+    }
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_retrieval_decode, 0)
+    ZEND_ARG_INFO(0, data)
+    ZEND_ARG_INFO(0, sink)
+    ZEND_ARG_INFO(0, chunk_size)
+ZEND_END_ARG_INFO()
+
+/* decodes every <Datenpaket> of an Abholung server response into the sink, returns the number of packages */
+PHP_METHOD(EricRetrieval, decodePackages)
+{
+    zend_string *response;
+    zval *sink;
+    zend_long chunkSize = ERIC_RETRIEVAL_CHUNK;
+    eric_retrieval *session;
+    const char *pos, *end, *start, *stop;
+    zend_long packages = 0;
+    zval written;
+
+    ZEND_PARSE_PARAMETERS_START(2,3)
+        Z_PARAM_STR(response)
+        Z_PARAM_ZVAL(sink)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(chunkSize)
+    ZEND_PARSE_PARAMETERS_END();
+
+    session = eric_retrieval_fetch(ZEND_THIS);
+    if(session == NULL) {
+        RETURN_THROWS();
+    }
+    if(chunkSize < 1 || !eric_sink_valid(sink)) {
+        zend_argument_value_error(2, "must be a stream or callable with a positive chunk size");
+        RETURN_THROWS();
+    }
+
+    pos = ZSTR_VAL(response);
+    end = pos + ZSTR_LEN(response);
+    while((start = php_memnstr(pos, "<Datenpaket", sizeof("<Datenpaket") - 1, end)) != NULL) {
+        start += sizeof("<Datenpaket") - 1;
+        if(*start != '>' && *start != ' ') {
+            pos = start; /* <DatenpaketXyz> */
+            continue;
+        }
+        start = memchr(start, '>', end - start);
+        if(start == NULL) {
+            break;
+        }
+        start++;
+        stop = php_memnstr(start, "</Datenpaket>", sizeof("</Datenpaket>") - 1, end);
+        if(stop == NULL) {
+            break;
+        }
+
+        char *base64 = estrndup(start, stop - start);
+        ERIC_G(errCode) = eric_retrieval_decode(session, base64, sink, chunkSize, &written);
+        efree(base64);
+        if(ERIC_G(errCode) != ERIC_OK) {
+            RETURN_FALSE;
+        }
+        packages++;
+        pos = stop + sizeof("</Datenpaket>") - 1;
+    }
+
+    RETURN_LONG(packages);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_retrieval_decode_packages, 0)
+    ZEND_ARG_INFO(0, server_response)
+    ZEND_ARG_INFO(0, sink)
+    ZEND_ARG_INFO(0, chunk_size)
+ZEND_END_ARG_INFO()
+
+PHP_METHOD(EricRetrieval, getTransferHandle)
+{
+    eric_retrieval *session;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    session = eric_retrieval_fetch(ZEND_THIS);
+    if(session == NULL) {
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG(session->transferHandle);
+}
+
+PHP_METHOD(EricRetrieval, close)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    eric_retrieval_close(eric_retrieval_from_obj(Z_OBJ_P(ZEND_THIS)));
+}
+
+ZEND_BEGIN_ARG_INFO(arginfo_eric_retrieval_none, 0)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry eric_retrieval_methods[] = {
+    PHP_ME(EricRetrieval, __construct, arginfo_eric_retrieval_construct, ZEND_ACC_PUBLIC)
+    PHP_ME(EricRetrieval, send, arginfo_eric_retrieval_send, ZEND_ACC_PUBLIC)
+    PHP_ME(EricRetrieval, decode, arginfo_eric_retrieval_decode, ZEND_ACC_PUBLIC)
+    PHP_ME(EricRetrieval, decodePackages, arginfo_eric_retrieval_decode_packages, ZEND_ACC_PUBLIC)
+    PHP_ME(EricRetrieval, getTransferHandle, arginfo_eric_retrieval_none, ZEND_ACC_PUBLIC)
+    PHP_ME(EricRetrieval, close, arginfo_eric_retrieval_none, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+/* explicitly opened certificate, the handle is not shared with the instance cert cache */
+typedef struct _eric_certificate {
+    eric_instance *inst;
+    EricZertifikatHandle handle;
+    uint32_t pinSupport;
+    char *path;
+    char *pin; /* last pin that passed checkPin() */
+    zend_string *properties; /* HoleZertifikatEigenschaften xml */
+    zend_object std;
+} eric_certificate;
+
+static zend_class_entry *eric_certificate_ce;
+static zend_object_handlers eric_certificate_handlers;
+
+static eric_certificate *eric_certificate_from_obj(zend_object *obj)
+{
+    return (eric_certificate *) ((char *) obj - XtOffsetOf(eric_certificate, std));
+}
+
+static void eric_certificate_close(eric_certificate *cert)
+{
+    if(cert->inst != NULL) {
+        ERIC_CALL(cert->inst, CloseHandleToCertificate, cert->handle);
+        eric_return_instance(cert->inst);
+        cert->inst = NULL;
+        cert->handle = 0;
+    }
+    if(cert->path != NULL) {
+        efree(cert->path);
+        cert->path = NULL;
+    }
+    if(cert->pin != NULL) {
+        efree(cert->pin);
+        cert->pin = NULL;
+    }
+    if(cert->properties != NULL) {
+        zend_string_release(cert->properties);
+        cert->properties = NULL;
+    }
+}
+
+static zend_object *eric_certificate_create(zend_class_entry *ce)
+{
+    eric_certificate *cert = zend_object_alloc(sizeof(eric_certificate), ce);
+
+    zend_object_std_init(&cert->std, ce);
+    object_properties_init(&cert->std, ce);
+    cert->std.handlers = &eric_certificate_handlers;
+
+    return &cert->std;
+}
+
+static void eric_certificate_free(zend_object *obj)
+{
+    eric_certificate_close(eric_certificate_from_obj(obj));
+    zend_object_std_dtor(obj);
+}
+
+static eric_certificate *eric_certificate_fetch(zval *zv)
+{
+    eric_certificate *cert = eric_certificate_from_obj(Z_OBJ_P(zv));
+
+    if(cert->inst == NULL) {
+        zend_throw_error(NULL, "EricCertificate is closed");
+
+        return NULL;
+    }
+
+    return cert;
+}
+
+PHP_METHOD(EricCertificate, __construct)
+{
+    char *path;
+    size_t pathLength;
+    eric_certificate *cert = eric_certificate_from_obj(Z_OBJ_P(ZEND_THIS));
+    int err;
+
+    ZEND_PARSE_PARAMETERS_START(1,1)
+        Z_PARAM_PATH(path, pathLength)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        zend_throw_exception(zend_ce_exception, "ericapilib not loaded", -1);
+        RETURN_THROWS();
+    }
+
+    eric_certificate_close(cert);
+    cert->inst = eric_borrow_instance();
+    if(cert->inst == NULL) {
+        zend_throw_exception(zend_ce_exception, "no eric instance available", ERIC_G(errCode));
+        RETURN_THROWS();
+    }
+
+    err = ERIC_CALL(cert->inst, GetHandleToCertificate, &cert->handle, &cert->pinSupport, path);
+    if(err != ERIC_OK) {
+        eric_return_instance(cert->inst);
+        cert->inst = NULL;
+        ERIC_G(errCode) = err;
+        zend_throw_exception(zend_ce_exception, "certificate could not be opened", err);
+        RETURN_THROWS();
+    }
+    cert->path = estrndup(path, pathLength);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_certificate_construct, 0)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+ZEND_END_ARG_INFO()
+
+PHP_METHOD(EricCertificate, getPath)
+{
+    eric_certificate *cert;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cert = eric_certificate_fetch(ZEND_THIS);
+    if(cert == NULL) {
+        RETURN_THROWS();
+    }
+
+    RETURN_STRING(cert->path);
+}
+
+PHP_METHOD(EricCertificate, getPinSupport)
+{
+    eric_certificate *cert;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cert = eric_certificate_fetch(ZEND_THIS);
+    if(cert == NULL) {
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG(cert->pinSupport);
+}
+
+PHP_METHOD(EricCertificate, requiresPin)
+{
+    eric_certificate *cert;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cert = eric_certificate_fetch(ZEND_THIS);
+    if(cert == NULL) {
+        RETURN_THROWS();
+    }
+
+    RETURN_BOOL((cert->pinSupport & ERIC_PIN_REQUIRED_MASK) != 0);
+}
+
+/* 0 pin ok, 1 locked, 2 last attempt failed, 3 locked on next failure; not cached, it changes with every attempt */
+PHP_METHOD(EricCertificate, getPinStatus)
+{
+    zend_long keyType = 0;
+    uint32_t status = 0;
+    eric_certificate *cert;
+
+    ZEND_PARSE_PARAMETERS_START(0,1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(keyType)
+    ZEND_PARSE_PARAMETERS_END();
+
+    cert = eric_certificate_fetch(ZEND_THIS);
+    if(cert == NULL) {
+        RETURN_THROWS();
+    }
+
+    ERIC_G(errCode) = ERIC_CALL(cert->inst, GetPinStatus, cert->handle, &status, (uint32_t) keyType);
+    if(ERIC_G(errCode) != ERIC_OK) {
+        RETURN_FALSE;
+    }
+
+    RETURN_LONG(status);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_certificate_key_type, 0)
+    ZEND_ARG_INFO(0, key_type)
+ZEND_END_ARG_INFO()
+
+/* checks against the keystore once per pin, a passed pin is kept for process() */
+PHP_METHOD(EricCertificate, checkPin)
+{
+    char *pin;
+    size_t pinLength;
+    zend_long keyType = 0;
+    eric_certificate *cert;
+
+    ZEND_PARSE_PARAMETERS_START(1,2)
+        Z_PARAM_STRING(pin, pinLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(keyType)
+    ZEND_PARSE_PARAMETERS_END();
+
+    cert = eric_certificate_fetch(ZEND_THIS);
+    if(cert == NULL) {
+        RETURN_THROWS();
+    }
+    if(cert->pin != NULL && strcmp(cert->pin, pin) == 0) {
+        RETURN_TRUE;
+    }
+
+    ERIC_G(errCode) = ERIC_CALL(cert->inst, PruefeZertifikatPin, cert->path, pin, (uint32_t) keyType);
+    if(ERIC_G(errCode) != ERIC_OK) {
+        RETURN_FALSE;
+    }
+    if(cert->pin != NULL) {
+        efree(cert->pin);
+    }
+    cert->pin = estrndup(pin, pinLength);
+
+    RETURN_TRUE;
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_certificate_check_pin, 0)
+    ZEND_ARG_INFO(0, pin)
+    ZEND_ARG_INFO(0, key_type)
+ZEND_END_ARG_INFO()
+
+/* certificate properties xml, fetched once per object */
+PHP_METHOD(EricCertificate, getProperties)
+{
+    char *pin = NULL;
+    size_t pinLength = 0;
+    eric_certificate *cert;
+
+    ZEND_PARSE_PARAMETERS_START(0,1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STRING_OR_NULL(pin, pinLength)
+    ZEND_PARSE_PARAMETERS_END();
+
+    cert = eric_certificate_fetch(ZEND_THIS);
+    if(cert == NULL) {
+        RETURN_THROWS();
+    }
+
+    if(cert->properties == NULL) {
+        EricRueckgabepufferHandle buf = eric_buffer_acquire(cert->inst);
+
+        ERIC_G(errCode) = ERIC_CALL(
+            cert->inst,
+            HoleZertifikatEigenschaften,
+            cert->handle,
+            pin != NULL ? pin : (cert->pin != NULL ? cert->pin : ""),
+            buf
+        );
+        if(ERIC_G(errCode) == ERIC_OK) {
+            cert->properties = eric_buffer_to_string(cert->inst, buf);
+        }
+        eric_buffer_release(cert->inst, buf);
+        if(cert->properties == NULL) {
+            RETURN_FALSE;
+        }
+    }
+
+    RETURN_STR_COPY(cert->properties);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_certificate_get_properties, 0)
+    ZEND_ARG_INFO(0, pin)
+ZEND_END_ARG_INFO()
+
+/* eric_process with this certificate, without reopening or rechecking it */
+PHP_METHOD(EricCertificate, process)
+{
+    zval *serverResponse;
+    char *dataType;
+    size_t dataTypeLength;
+    char *xml;
+    size_t xmlLength;
+    zend_long flags = ERIC_SENDE;
+    char *pin = NULL;
+    size_t pinLength = 0;
+    zval *serverAnswer = NULL;
+    eric_certificate *cert;
+    eric_job job;
+
+    ZEND_PARSE_PARAMETERS_START(3,6)
+        Z_PARAM_ZVAL(serverResponse)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_STRING(xml, xmlLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(flags)
+        Z_PARAM_STRING_OR_NULL(pin, pinLength)
+        Z_PARAM_ZVAL(serverAnswer)
+    ZEND_PARSE_PARAMETERS_END();
+
+    cert = eric_certificate_fetch(ZEND_THIS);
+    if(cert == NULL) {
+        RETURN_THROWS();
+    }
+
+    memset(&job, 0, sizeof(eric_job));
+    job.dataType = dataType;
+    job.xml = xml;
+    job.flags = (uint32_t) flags;
+    job.cert = cert->handle;
+    job.certPinSupport = cert->pinSupport;
+    job.pin = pin != NULL ? pin : cert->pin;
+    job.parseAnswer = serverAnswer != NULL;
+
+    eric_job_run(cert->inst, &job);
+    ERIC_G(errCode) = job.err;
+    memcpy(&ERIC_G(lastTimings), &job.timings, sizeof(eric_timings));
+
+    if(job.serverResponse != NULL) {
+        ZEND_TRY_ASSIGN_REF_STR(serverResponse, job.serverResponse);
+    }
+    if(serverAnswer != NULL) {
+        eric_job_assign_answer(&job, serverAnswer);
+    }
+    if(job.returnXml != NULL && (ZSTR_LEN(job.returnXml) > 0 || job.err == ERIC_OK)) {
+        RETURN_STR(job.returnXml);
+    }
+    if(job.returnXml != NULL) {
+        zend_string_release(job.returnXml);
+    }
+
+    RETURN_FALSE;
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_certificate_process, 1)
+    ZEND_ARG_INFO(1, server_response)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, flags)
+    ZEND_ARG_INFO(0, pin)
+    ZEND_ARG_INFO(1, server_answer)
+ZEND_END_ARG_INFO()
+
+PHP_METHOD(EricCertificate, close)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    eric_certificate_close(eric_certificate_from_obj(Z_OBJ_P(ZEND_THIS)));
+}
+
+static const zend_function_entry eric_certificate_methods[] = {
+    PHP_ME(EricCertificate, __construct, arginfo_eric_certificate_construct, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, getPath, arginfo_eric_retrieval_none, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, getPinSupport, arginfo_eric_retrieval_none, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, requiresPin, arginfo_eric_retrieval_none, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, getPinStatus, arginfo_eric_certificate_key_type, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, checkPin, arginfo_eric_certificate_check_pin, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, getProperties, arginfo_eric_certificate_get_properties, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, process, arginfo_eric_certificate_process, ZEND_ACC_PUBLIC)
+    PHP_ME(EricCertificate, close, arginfo_eric_retrieval_none, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+static PHP_GINIT_FUNCTION(eric)
+{
+#if defined(COMPILE_DL_ERIC) && defined(ZTS)
+    ZEND_TSRMLS_CACHE_UPDATE();
+#endif
+    memset(eric_globals, 0, sizeof(zend_eric_globals));
+}
+
+PHP_MINIT_FUNCTION(eric)
+{
+    REGISTER_INI_ENTRIES();
+
+    lericapi = dlopen(INI_STR("eric.library_path"), RTLD_NOW);
+    if(!lericapi) {
+        php_log_err("cant dlopen lericapi\n");
+        php_log_err(dlerror());
+        
+        return FAILURE;
+    }
+
+    pEricInitialisiere = dlsym(lericapi, "EricInitialisiere");
+    pEricBeende = dlsym(lericapi, "EricBeende");
+    pEricChangePassword = dlsym(lericapi, "EricChangePassword");
+    pEricPruefeBuFaNummer = dlsym(lericapi, "EricPruefeBuFaNummer");
+    pEricBearbeiteVorgang = dlsym(lericapi, "EricBearbeiteVorgang");
+    pEricCheckXML = dlsym(lericapi, "EricCheckXML");
+    pEricCloseHandleToCertificate = dlsym(lericapi, "EricCloseHandleToCertificate");
+    pEricCreateKey = dlsym(lericapi, "EricCreateKey");
+    pEricCreateTH = dlsym(lericapi, "EricCreateTH");
+    pEricDekodiereDaten = dlsym(lericapi, "EricDekodiereDaten");
+    pEricEinstellungAlleZuruecksetzen = dlsym(lericapi, "EricEinstellungAlleZuruecksetzen");
+    pEricEinstellungLesen = dlsym(lericapi, "EricEinstellungLesen");
+    pEricEinstellungSetzen = dlsym(lericapi, "EricEinstellungSetzen");
+    pEricEinstellungZuruecksetzen = dlsym(lericapi, "EricEinstellungZuruecksetzen");
+    pEricEntladePlugins = dlsym(lericapi, "EricEntladePlugins");
+    pEricFormatStNr = dlsym(lericapi, "EricFormatStNr");
+    pEricGetAuswahlListen = dlsym(lericapi, "EricGetAuswahlListen");
+    pEricGetErrormessagesFromXMLAnswer = dlsym(lericapi, "EricGetErrormessagesFromXMLAnswer");
+    pEricGetHandleToCertificate = dlsym(lericapi, "EricGetHandleToCertificate");
+    pEricGetPinStatus = dlsym(lericapi, "EricGetPinStatus");
+    pEricGetPublicKey = dlsym(lericapi, "EricGetPublicKey");
+    pEricHoleFehlerText = dlsym(lericapi, "EricHoleFehlerText");
+    pEricHoleFinanzaemter = dlsym(lericapi, "EricHoleFinanzaemter");
+    pEricHoleFinanzamtLandNummern = dlsym(lericapi, "EricHoleFinanzamtLandNummern");
+    pEricHoleFinanzamtsdaten = dlsym(lericapi, "EricHoleFinanzamtsdaten");
+    pEricHoleTestfinanzaemter = dlsym(lericapi, "EricHoleTestfinanzaemter");
+    pEricHoleZertifikatEigenschaften = dlsym(lericapi, "EricHoleZertifikatEigenschaften");
+    pEricHoleZertifikatFingerabdruck = dlsym(lericapi, "EricHoleZertifikatFingerabdruck");
+    pEricMakeElsterStnr = dlsym(lericapi, "EricMakeElsterStnr");
+    pEricPruefeBIC = dlsym(lericapi, "EricPruefeBIC");
+    pEricPruefeIBAN = dlsym(lericapi, "EricPruefeIBAN");
+    pEricPruefeSteuernummer = dlsym(lericapi, "EricPruefeSteuernummer");
+    pEricPruefeIdentifikationsMerkmal = dlsym(lericapi, "EricPruefeIdentifikationsMerkmal");
+    pEricPruefeZertifikatPin = dlsym(lericapi, "EricPruefeZertifikatPin");
+    pEricRegistriereFortschrittCallback = dlsym(lericapi, "EricRegistriereFortschrittCallback");
+    pEricRegistriereGlobalenFortschrittCallback = dlsym(lericapi, "EricRegistriereGlobalenFortschrittCallback");
+    pEricRegistriereLogCallback = dlsym(lericapi, "EricRegistriereLogCallback");
+    pEricRueckgabepufferErzeugen = dlsym(lericapi, "EricRueckgabepufferErzeugen");
+    pEricRueckgabepufferFreigeben = dlsym(lericapi, "EricRueckgabepufferFreigeben");
+    pEricRueckgabepufferInhalt = dlsym(lericapi, "EricRueckgabepufferInhalt");
+    pEricRueckgabepufferLaenge = dlsym(lericapi, "EricRueckgabepufferLaenge");
+    pEricSystemCheck = dlsym(lericapi, "EricSystemCheck");
+    pEricVersion = dlsym(lericapi, "EricVersion");
+
+    pEricMtInstanzErzeugen = dlsym(lericapi, "EricMtInstanzErzeugen");
+    pEricMtInstanzFreigeben = dlsym(lericapi, "EricMtInstanzFreigeben");
+    pEricMtChangePassword = dlsym(lericapi, "EricMtChangePassword");
+    pEricMtPruefeBuFaNummer = dlsym(lericapi, "EricMtPruefeBuFaNummer");
+    pEricMtBearbeiteVorgang = dlsym(lericapi, "EricMtBearbeiteVorgang");
+    pEricMtCheckXML = dlsym(lericapi, "EricMtCheckXML");
+    pEricMtCloseHandleToCertificate = dlsym(lericapi, "EricMtCloseHandleToCertificate");
+    pEricMtCreateKey = dlsym(lericapi, "EricMtCreateKey");
+    pEricMtCreateTH = dlsym(lericapi, "EricMtCreateTH");
+    pEricMtDekodiereDaten = dlsym(lericapi, "EricMtDekodiereDaten");
+    pEricMtEinstellungAlleZuruecksetzen = dlsym(lericapi, "EricMtEinstellungAlleZuruecksetzen");
+    pEricMtEinstellungLesen = dlsym(lericapi, "EricMtEinstellungLesen");
+    pEricMtEinstellungSetzen = dlsym(lericapi, "EricMtEinstellungSetzen");
+    pEricMtEinstellungZuruecksetzen = dlsym(lericapi, "EricMtEinstellungZuruecksetzen");
+    pEricMtEntladePlugins = dlsym(lericapi, "EricMtEntladePlugins");
+    pEricMtFormatStNr = dlsym(lericapi, "EricMtFormatStNr");
+    pEricMtGetAuswahlListen = dlsym(lericapi, "EricMtGetAuswahlListen");
+    pEricMtGetErrormessagesFromXMLAnswer = dlsym(lericapi, "EricMtGetErrormessagesFromXMLAnswer");
+    pEricMtGetHandleToCertificate = dlsym(lericapi, "EricMtGetHandleToCertificate");
+    pEricMtGetPinStatus = dlsym(lericapi, "EricMtGetPinStatus");
+    pEricMtGetPublicKey = dlsym(lericapi, "EricMtGetPublicKey");
+    pEricMtHoleFehlerText = dlsym(lericapi, "EricMtHoleFehlerText");
+    pEricMtHoleFinanzaemter = dlsym(lericapi, "EricMtHoleFinanzaemter");
+    pEricMtHoleFinanzamtLandNummern = dlsym(lericapi, "EricMtHoleFinanzamtLandNummern");
+    pEricMtHoleFinanzamtsdaten = dlsym(lericapi, "EricMtHoleFinanzamtsdaten");
+    pEricMtHoleTestfinanzaemter = dlsym(lericapi, "EricMtHoleTestfinanzaemter");
+    pEricMtHoleZertifikatEigenschaften = dlsym(lericapi, "EricMtHoleZertifikatEigenschaften");
+    pEricMtHoleZertifikatFingerabdruck = dlsym(lericapi, "EricMtHoleZertifikatFingerabdruck");
+    pEricMtMakeElsterStnr = dlsym(lericapi, "EricMtMakeElsterStnr");
+    pEricMtPruefeBIC = dlsym(lericapi, "EricMtPruefeBIC");
+    pEricMtPruefeIBAN = dlsym(lericapi, "EricMtPruefeIBAN");
+    pEricMtPruefeIdentifikationsMerkmal = dlsym(lericapi, "EricMtPruefeIdentifikationsMerkmal");
+    pEricMtPruefeSteuernummer = dlsym(lericapi, "EricMtPruefeSteuernummer");
+    pEricMtPruefeZertifikatPin = dlsym(lericapi, "EricMtPruefeZertifikatPin");
+    pEricMtRegistriereFortschrittCallback = dlsym(lericapi, "EricMtRegistriereFortschrittCallback");
+    pEricMtRegistriereGlobalenFortschrittCallback = dlsym(lericapi, "EricMtRegistriereGlobalenFortschrittCallback");
+    pEricMtRegistriereLogCallback = dlsym(lericapi, "EricMtRegistriereLogCallback");
+    pEricMtRueckgabepufferErzeugen = dlsym(lericapi, "EricMtRueckgabepufferErzeugen");
+    pEricMtRueckgabepufferFreigeben = dlsym(lericapi, "EricMtRueckgabepufferFreigeben");
+    pEricMtRueckgabepufferInhalt = dlsym(lericapi, "EricMtRueckgabepufferInhalt");
+    pEricMtRueckgabepufferLaenge = dlsym(lericapi, "EricMtRueckgabepufferLaenge");
+    pEricMtSystemCheck = dlsym(lericapi, "EricMtSystemCheck");
+    pEricMtVersion = dlsym(lericapi, "EricMtVersion");
+
+    eric_plugin_path_ini = pestrdup(INI_STR("eric.plugin_path"), 1);
+    eric_log_path_ini = pestrdup(INI_STR("eric.log_path"), 1);
+    eric_cert_cache_size = INI_INT("eric.cert_cache_size");
+    eric_check_cache_size = INI_INT("eric.check_cache_size");
+    eric_retry_attempts = MAX(1, INI_INT("eric.retry_attempts"));
+    eric_retry_backoff = MAX(0, INI_INT("eric.retry_backoff"));
+    eric_retry_backoff_max = MAX(eric_retry_backoff, INI_INT("eric.retry_backoff_max"));
+    eric_retry_resend = INI_INT("eric.retry_resend") != 0;
+    eric_buffer_pool_size = INI_INT("eric.buffer_pool_size");
+    eric_mt_enabled = INI_INT("eric.multithreading") != 0;
+    eric_pool_size = INI_INT("eric.instance_pool_size");
+    if(eric_pool_size < 1) {
+        eric_pool_size = 1;
+    }
+    if(eric_mt_enabled && pEricMtInstanzErzeugen == NULL) {
+        php_log_err("eric: multithreading api not available, falling back to singlethreading\n");
+        eric_mt_enabled = 0;
+    }
+
+    eric_instance_init(&eric_st_instance, NULL);
+
+    size_t logSize = 16;
+    while(logSize < (size_t) MAX(INI_INT("eric.log_buffer_size"), 1)) {
+        logSize <<= 1;
+    }
+    eric_log.slots = pecalloc(logSize, sizeof(eric_log_slot), 1);
+    eric_log.mask = logSize - 1;
+    for(size_t i = 0; i < logSize; i++) {
+        eric_log.slots[i].seq = i;
+    }
+    eric_log_level = INI_INT("eric.log_level");
+    if(strcmp(INI_STR("eric.log_handler"), "buffer") == 0) {
+        eric_log_handler = ERIC_LOG_HANDLER_BUFFER;
+        eric_log_generation = 1;
+    } else if(strcmp(INI_STR("eric.log_handler"), "syslog") == 0) {
+        eric_log_handler = ERIC_LOG_HANDLER_SYSLOG;
+        eric_log_generation = 1; /* the drain thread is started per process in RINIT */
+    }
+
+    le_eric_future = zend_register_list_destructors_ex(eric_future_dtor, NULL, "eric future", module_number);
+
+    zend_class_entry ce;
+    INIT_CLASS_ENTRY(ce, "EricRetrieval", eric_retrieval_methods);
+    eric_retrieval_ce = zend_register_internal_class(&ce);
+    eric_retrieval_ce->ce_flags |= ZEND_ACC_FINAL;
+    eric_retrieval_ce->create_object = eric_retrieval_create;
+    memcpy(&eric_retrieval_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    eric_retrieval_handlers.offset = XtOffsetOf(eric_retrieval, std);
+    eric_retrieval_handlers.free_obj = eric_retrieval_free;
+    eric_retrieval_handlers.clone_obj = NULL;
+
+    INIT_CLASS_ENTRY(ce, "EricCertificate", eric_certificate_methods);
+    eric_certificate_ce = zend_register_internal_class(&ce);
+    eric_certificate_ce->ce_flags |= ZEND_ACC_FINAL;
+    eric_certificate_ce->create_object = eric_certificate_create;
+    memcpy(&eric_certificate_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    eric_certificate_handlers.offset = XtOffsetOf(eric_certificate, std);
+    eric_certificate_handlers.free_obj = eric_certificate_free;
+    eric_certificate_handlers.clone_obj = NULL;
+
+    REGISTER_LONG_CONSTANT("ERIC_VALIDIERE", ERIC_VALIDIERE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_SENDE", ERIC_SENDE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_DRUCKE", ERIC_DRUCKE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_PRUEFE_HINWEISE", ERIC_PRUEFE_HINWEISE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_HANDLER_FILE", ERIC_LOG_HANDLER_FILE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_HANDLER_BUFFER", ERIC_LOG_HANDLER_BUFFER, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_HANDLER_SYSLOG", ERIC_LOG_HANDLER_SYSLOG, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_TRACE", ERIC_LOG_TRACE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_DEBUG", ERIC_LOG_DEBUG, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_INFO", ERIC_LOG_INFO, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_WARN", ERIC_LOG_WARN, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("ERIC_LOG_ERROR", ERIC_LOG_ERROR, CONST_CS | CONST_PERSISTENT);
+
+    memset(&eric_tax_offices, 0, sizeof(eric_tax_office_cache));
+    pthread_mutex_init(&eric_tax_offices.mutex, NULL);
+    zend_hash_init(&eric_tax_offices.offices, 32, NULL, NULL, 1);
+    zend_hash_init(&eric_epoch_requests, 8, NULL, NULL, 1);
+
+    memset(&eric_checks, 0, sizeof(eric_check_cache));
+    pthread_mutex_init(&eric_checks.mutex, NULL);
+    zend_hash_init(&eric_checks.entries, 32, NULL, NULL, 1);
+
+    eric_error_register_class();
+
+    memset(&eric_error_texts, 0, sizeof(eric_error_text_cache));
+    pthread_mutex_init(&eric_error_texts.mutex, NULL);
+    zend_hash_init(&eric_error_texts.texts, 64, NULL, NULL, 1);
+
+    return SUCCESS;
+}
+
+PHP_MSHUTDOWN_FUNCTION(eric)
+{
+    eric_async_shutdown();
+    eric_spool_close();
+
+    if(lericapi) {
+        while(eric_pool_all != NULL) {
+            eric_instance *inst = eric_pool_all;
+            eric_pool_all = inst->nextCreated;
+
+            eric_log_unregister(inst);
+            eric_instance_destroy(inst);
+            pEricMtInstanzFreigeben(inst->handle);
+            pefree(inst, 1);
+        }
+        eric_pool_free = NULL;
+        eric_pool_created = 0;
+
+        eric_log_unregister(&eric_st_instance);
+        eric_instance_destroy(&eric_st_instance);
+        if(!eric_mt_enabled) {
+            pEricBeende();
+        }
+
+        dlclose(lericapi); /* no need 4 nullset */ 
+    }
+
+    eric_log_syslog_stop();
+    if(eric_log_syslog_fd >= 0) {
+        close(eric_log_syslog_fd);
+        eric_log_syslog_fd = -1;
+    }
+    if(eric_log.slots != NULL) {
+        pefree(eric_log.slots, 1);
+        eric_log.slots = NULL;
+    }
+
+    if(eric_plugin_path_ini != NULL) {
+        pefree(eric_plugin_path_ini, 1);
+        pefree(eric_log_path_ini, 1);
+        eric_plugin_path_ini = eric_log_path_ini = NULL;
+    }
+
+    eric_tax_office_cache_flush_locked();
+    zend_hash_destroy(&eric_tax_offices.offices);
+    if(eric_tax_offices.version != NULL) {
+        zend_string_release_ex(eric_tax_offices.version, 1);
+    }
+    pthread_mutex_destroy(&eric_tax_offices.mutex);
+    eric_check_cache_flush_locked();
+    zend_hash_destroy(&eric_checks.entries);
+    if(eric_checks.version != NULL) {
+        zend_string_release_ex(eric_checks.version, 1);
+    }
+    pthread_mutex_destroy(&eric_checks.mutex);
+    zend_string *text;
+    ZEND_HASH_FOREACH_PTR(&eric_error_texts.texts, text) {
+        pefree(text, 1);
+    } ZEND_HASH_FOREACH_END();
+    zend_hash_destroy(&eric_error_texts.texts);
+    if(eric_error_texts.version != NULL) {
+        zend_string_release_ex(eric_error_texts.version, 1);
+    }
+    pthread_mutex_destroy(&eric_error_texts.mutex);
+    zend_hash_destroy(&eric_error_index);
+    eric_retired_reclaim(1);
+    zend_hash_destroy(&eric_epoch_requests);
+
+    UNREGISTER_INI_ENTRIES();
+
+    return SUCCESS;
+}
+
+PHP_RINIT_FUNCTION(eric)
+{
+#if defined(COMPILE_DL_ERIC) && defined(ZTS)
+    ZEND_TSRMLS_CACHE_UPDATE();
+#endif
+
+    ERIC_G(errCode) = 0;
+    ERIC_G(instance) = NULL;
+    ERIC_G(notifier) = NULL;
+
+    memset(&ERIC_G(lastTimings), 0, sizeof(eric_timings));
+    eric_epoch_enter();
+
+    if(__atomic_load_n(&eric_log_handler, __ATOMIC_RELAXED) == ERIC_LOG_HANDLER_SYSLOG
+        && __atomic_load_n(&eric_log_syslog_pid, __ATOMIC_RELAXED) != getpid()
+    ) {
+        pthread_mutex_lock(&eric_log_mutex);
+        if(eric_log_handler == ERIC_LOG_HANDLER_SYSLOG) {
+            eric_log_syslog_start();
+        }
+        pthread_mutex_unlock(&eric_log_mutex);
+    }
+
+    return SUCCESS;
+}
+
+PHP_RSHUTDOWN_FUNCTION(eric)
+{
+    eric_async_notifier_release(ERIC_G(notifier)); /* pending futures keep it open */
+    ERIC_G(notifier) = NULL;
+    eric_request_instance_release(1);
+    ERIC_G(instance) = NULL;
+    eric_epoch_leave();
+
+    return SUCCESS;
+}
+
+PHP_FUNCTION(eric_init)
+{
+    if(eric_mt_enabled) {
+        RETURN_BOOL(eric_request_instance() != NULL); /* instances are created initialised */
+    }
+
+    char logPath[MAXPATHLEN];
+    int err = pEricInitialisiere(
+        eric_plugin_path(),
+        eric_log_path(logPath, sizeof(logPath), 0)
+    );
+    if(err == ERIC_OK)  {
+        eric_reference_cache_sync(&eric_st_instance); /* plugins may have been updated */
+        eric_log_sync(&eric_st_instance);
+        eric_progress_register(&eric_st_instance);
+
+        RETURN_TRUE;
+    }
+    ERIC_G(errCode) = err;
+    RETURN_FALSE;
+}
+
+PHP_FUNCTION(eric_close)
+{
+    if(eric_mt_enabled) {
+        eric_request_instance_release(0); /* back to the pool, cert cache stays warm */
+
+        RETURN_TRUE;
+    }
+
+    eric_cert_cache_flush_all(&eric_st_instance); /* handles die with the api */
+    eric_buffer_pool_flush(&eric_st_instance);
+    eric_log_unregister(&eric_st_instance);
+    eric_st_instance.progressRegistered = 0;
+
+    int err = pEricBeende();
+    if(err == ERIC_OK) {
+        RETURN_BOOL(IS_TRUE);
+    }
+    ERIC_G(errCode) = err;
+    RETURN_BOOL(IS_FALSE);
+}
+
+PHP_FUNCTION(eric_get_tax_office_country_numbers) /* je bundesland */
+{
+    zend_bool asArray = 0;
+
+    ZEND_PARSE_PARAMETERS_START(0,1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(asArray)
+    ZEND_PARSE_PARAMETERS_END();
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    int ret = eric_tax_office_lookup(inst, NULL, 0, asArray, return_value);
+    if(ret != ERIC_OK) {
+        ERIC_G(errCode) = ret;
+        php_log_err("eric_get_tax_office_country_numbers error");
+
+        RETURN_FALSE;
+    }
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_get_tax_office_country_numbers, 0)
+    ZEND_ARG_INFO(0, as_array)
+ZEND_END_ARG_INFO();
+
+PHP_FUNCTION(eric_get_tax_offices_for_country_number)
+{
+    char *cn;
+    size_t cnlen;
+    zend_bool asArray = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1,2)
+        Z_PARAM_STRING(cn, cnlen)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(asArray)
+    ZEND_PARSE_PARAMETERS_END();
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    int ret = eric_tax_office_lookup(inst, cn, cnlen, asArray, return_value);
+    if(ret != ERIC_OK) {
+        ERIC_G(errCode) = ret;
+        if(ret == ERIC_GLOBAL_UTI_COUNTRY_NOT_SUPPORTED) {
+            php_log_err("eric country code not supported eric_get_tax_offices_for_country_number error\n");
+        }
+
+        RETURN_FALSE;
+    }
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_get_tax_offices_for_country_number, 1)
+    ZEND_ARG_INFO(0, country_number)
+    ZEND_ARG_INFO(0, as_array)
+ZEND_END_ARG_INFO();
+
+PHP_FUNCTION(eric_tax_office_cache_flush)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    pthread_mutex_lock(&eric_tax_offices.mutex);
+    int flushed = eric_tax_office_cache_flush_locked();
+    pthread_mutex_unlock(&eric_tax_offices.mutex);
+
+    RETURN_LONG(flushed);
+}
+
+PHP_FUNCTION(eric_tax_office_cache_stats)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    array_init(return_value);
+
+    pthread_mutex_lock(&eric_tax_offices.mutex);
+    add_assoc_long(return_value, "hits", eric_tax_offices.hits);
+    add_assoc_long(return_value, "misses", eric_tax_offices.misses);
+    add_assoc_long(
+        return_value,
+        "entries",
+        zend_hash_num_elements(&eric_tax_offices.offices) + (eric_tax_offices.countryNumbers != NULL)
+    );
+    pthread_mutex_unlock(&eric_tax_offices.mutex);
+}
+
+PHP_FUNCTION(eric_format_tax_number)
+{
+    char *orig;
+    size_t origLen;
+
+    ZEND_PARSE_PARAMETERS_START(1,1)
+        Z_PARAM_STRING(orig, origLen);
+    ZEND_PARSE_PARAMETERS_END();
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    EricRueckgabepufferHandle hout = eric_buffer_acquire(inst);
+    int format = ERIC_CALL(
+        inst,
+        FormatStNr,
+        orig,
+        hout
+    );
+    if(format != ERIC_OK) {
+        if(format == ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG) {
+            php_log_err("steuernummer ungültig\n");
+        }
+
+        eric_buffer_release(inst, hout);
+
+        RETURN_FALSE;
+    }
+
+    RETVAL_STR(eric_buffer_to_string(inst, hout));
+    eric_buffer_release(inst, hout);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_format_tax_number, 1)
+    ZEND_ARG_INFO(0, tax_number)
+ZEND_END_ARG_INFO();
+
+PHP_FUNCTION(eric_format_tax_number_to_elster)
+{
+    char *orig;
+    size_t origLen;
+    char *countryCode;
+    size_t ccLen;
+    char *taxOfficeId;
+    size_t toiLen;
+
+    ZEND_PARSE_PARAMETERS_START(3,3)
+        Z_PARAM_STRING(orig, origLen);
+        Z_PARAM_STRING(countryCode, ccLen);
+        Z_PARAM_STRING(taxOfficeId, toiLen);
+    ZEND_PARSE_PARAMETERS_END();
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    EricRueckgabepufferHandle hout = eric_buffer_acquire(inst);
+    int format = ERIC_CALL(
+        inst,
+        MakeElsterStnr,
+        orig,
+        countryCode,
+        taxOfficeId,
+        hout
+    );
+    if(format != ERIC_OK) {
+        if(format == ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG) {
+            php_log_err("eric_format_tax_number_to_elster: steuernummer ungültig\n");
+        }
+        if(format == ERIC_GLOBAL_LANDESNUMMER_UNBEKANNT) {
+            php_log_err("eric_format_tax_number_to_elster: landesnummer unbekannt\n");
+        }
+
+        eric_buffer_release(inst, hout);
+
+        RETURN_FALSE;
+    }
+
+    RETVAL_STR(eric_buffer_to_string(inst, hout));
+    eric_buffer_release(inst, hout);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_format_tax_number_to_elster, 1)
+    ZEND_ARG_INFO(0, tax_number)
+    ZEND_ARG_INFO(0, country_code)
+    ZEND_ARG_INFO(0, tax_office_id)
+ZEND_END_ARG_INFO();
+
+/* values are handed out in chunks to the calling thread and to workers with their own instance */
+#define ERIC_VALIDATION_CHUNK 256
+
+typedef int (*eric_validator)(eric_instance *inst, const char *value);
+
+typedef struct _eric_validation_batch {
+    eric_validator validator;
+    zend_string **values;
+    zend_long *codes;
+    uint32_t count;
+    uint32_t next;
+    pthread_mutex_t mutex;
+} eric_validation_batch;
+
+static int eric_validate_iban(eric_instance *inst, const char *value)
+{
+    return ERIC_CALL(inst, PruefeIBAN, value);
+}
+
+static int eric_validate_bic(eric_instance *inst, const char *value)
+{
+    return ERIC_CALL(inst, PruefeBIC, value);
+}
+
+static int eric_validate_tax_id(eric_instance *inst, const char *value)
+{
+    return ERIC_CALL(inst, PruefeIdentifikationsMerkmal, value);
+}
+
+static int eric_validate_tax_number(eric_instance *inst, const char *value)
+{
+    return ERIC_CALL(inst, PruefeSteuernummer, value);
+}
+
+static int eric_validate_tax_office_number(eric_instance *inst, const char *value)
+{
+    return ERIC_CALL(inst, PruefeBuFaNummer, value);
+}
+
+/* in-extension IBAN/BIC/IdNr checks returning the same codes as libericapi, see eric.native_validators */
+typedef int (*eric_native_validator)(const char *value, size_t len);
+
+/* IBAN registry country codes and lengths */
+static const struct { char country[3]; unsigned char length; } eric_iban_lengths[] = {
+    {"AD", 24}, {"AE", 23}, {"AL", 28}, {"AT", 20}, {"AZ", 28}, {"BA", 20}, {"BE", 16}, {"BG", 22},
+    {"BH", 22}, {"BI", 27}, {"BR", 29}, {"BY", 28}, {"CH", 21}, {"CR", 22}, {"CY", 28}, {"CZ", 24},
+    {"DE", 22}, {"DJ", 27}, {"DK", 18}, {"DO", 28}, {"EE", 20}, {"EG", 29}, {"ES", 24}, {"FI", 18},
+    {"FK", 18}, {"FO", 18}, {"FR", 27}, {"GB", 22}, {"GE", 22}, {"GI", 23}, {"GL", 18}, {"GR", 27},
+    {"GT", 28}, {"HR", 21}, {"HU", 28}, {"IE", 22}, {"IL", 23}, {"IQ", 23}, {"IS", 26}, {"IT", 27},
+    {"JO", 30}, {"KW", 30}, {"KZ", 20}, {"LB", 28}, {"LC", 32}, {"LI", 21}, {"LT", 20}, {"LU", 20},
+    {"LV", 21}, {"LY", 25}, {"MC", 27}, {"MD", 24}, {"ME", 22}, {"MK", 19}, {"MN", 20}, {"MR", 27},
+    {"MT", 31}, {"MU", 30}, {"NI", 28}, {"NL", 18}, {"NO", 15}, {"OM", 23}, {"PK", 24}, {"PL", 28},
+    {"PS", 29}, {"PT", 25}, {"QA", 29}, {"RO", 24}, {"RS", 22}, {"RU", 33}, {"SA", 24}, {"SC", 31},
+    {"SD", 18}, {"SE", 24}, {"SI", 19}, {"SK", 24}, {"SM", 27}, {"SO", 23}, {"ST", 25}, {"SV", 28},
+    {"TL", 23}, {"TN", 24}, {"TR", 26}, {"UA", 29}, {"VA", 22}, {"VG", 24}, {"XK", 20}, {"YE", 30}
+};
+
+/* ISO 3166-1 alpha-2 plus XK, as used in BIC country codes */
+static const char eric_iso_countries[] =
+    "ADAEAFAGAIALAMAOAQARASATAUAWAXAZBABBBDBEBFBGBHBIBJBLBMBNBOBQBRBSBTBVBWBYBZ"
+    "CACCCDCFCGCHCICKCLCMCNCOCRCUCVCWCXCYCZDEDJDKDMDODZECEEEGEHERESETFIFJFKFMFO"
+    "FRGAGBGDGEGFGGGHGIGLGMGNGPGQGRGSGTGUGWGYHKHMHNHRHTHUIDIEILIMINIOIQIRISITJE"
+    "JMJOJPKEKGKHKIKMKNKPKRKWKYKZLALBLCLILKLRLSLTLULVLYMAMCMDMEMFMGMHMKMLMMMNMO"
+    "MPMQMRMSMTMUMVMWMXMYMZNANCNENFNGNINLNONPNRNUNZOMPAPEPFPGPHPKPLPMPNPRPSPTPW"
+    "PYQARERORSRURWSASBSCSDSESGSHSISJSKSLSMSNSOSRSSSTSVSXSYSZTCTDTFTGTHTJTKTLTM"
+    "TNTOTRTTTVTWTZUAUGUMUSUYUZVAVCVEVGVIVNVUWFWSXKYEYTZAZMZW";
+
+#define ERIC_IS_UPPER(c) ((c) >= 'A' && (c) <= 'Z')
+#define ERIC_IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+static int eric_native_iban(const char *iban, size_t len)
+{
+    size_t i;
+    int known = 0;
+    uint32_t rem = 0;
+
+    if(len < 5 || len > 34 || !ERIC_IS_UPPER(iban[0]) || !ERIC_IS_UPPER(iban[1])
+        || !ERIC_IS_DIGIT(iban[2]) || !ERIC_IS_DIGIT(iban[3])
+    ) {
+        return ERIC_GLOBAL_IBAN_FORMALER_FEHLER;
+    }
+    for(i = 4; i < len; i++) {
+        if(!ERIC_IS_UPPER(iban[i]) && !ERIC_IS_DIGIT(iban[i])) {
+            return ERIC_GLOBAL_IBAN_FORMALER_FEHLER;
+        }
+    }
+
+    for(i = 0; i < sizeof(eric_iban_lengths) / sizeof(eric_iban_lengths[0]); i++) {
+        if(iban[0] == eric_iban_lengths[i].country[0] && iban[1] == eric_iban_lengths[i].country[1]) {
+            if(len != eric_iban_lengths[i].length) {
+                return ERIC_GLOBAL_IBAN_LANDESFORMAT_FEHLER;
+            }
+            known = 1;
+            break;
+        }
+    }
+    if(!known) {
+        return ERIC_GLOBAL_IBAN_LAENDERCODE_FEHLER;
+    }
+
+    /* mod 97 over bban + country + check digits, letters count as 10..35 */
+    for(i = 0; i < len; i++) {
+        char c = iban[(i + 4) % len];
+
+        if(ERIC_IS_DIGIT(c)) {
+            rem = (rem * 10 + (c - '0')) % 97;
+        } else {
+            rem = (rem * 100 + (c - 'A' + 10)) % 97;
+        }
+    }
+
+    return rem == 1 ? ERIC_OK : ERIC_GLOBAL_IBAN_PRUEFZIFFER_FEHLER;
+}
+
+static int eric_native_bic(const char *bic, size_t len)
+{
+    size_t i;
+
+    if(len != 8 && len != 11) {
+        return ERIC_GLOBAL_BIC_FORMALER_FEHLER;
+    }
+    for(i = 0; i < len; i++) {
+        if(i < 6 ? !ERIC_IS_UPPER(bic[i]) : !(ERIC_IS_UPPER(bic[i]) || ERIC_IS_DIGIT(bic[i]))) {
+            return ERIC_GLOBAL_BIC_FORMALER_FEHLER;
+        }
+    }
+    for(i = 0; i < sizeof(eric_iso_countries) - 1; i += 2) {
+        if(bic[4] == eric_iso_countries[i] && bic[5] == eric_iso_countries[i + 1]) {
+            return ERIC_OK;
+        }
+    }
+
+    return ERIC_GLOBAL_BIC_LAENDERCODE_FEHLER;
+}
+
+/* 11 digits, no leading 0, one digit repeated 2-3 times (never 3 in a row), ISO 7064 MOD 11,10 */
+static int eric_native_tax_id(const char *idnr, size_t len)
+{
+    int counts[10] = {0};
+    int i, product = 10, sum, repeated = -1;
+
+    if(len != 11 || idnr[0] == '0') {
+        return ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+    }
+    for(i = 0; i < 11; i++) {
+        if(!ERIC_IS_DIGIT(idnr[i])) {
+            return ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+        }
+    }
+
+    for(i = 0; i < 10; i++) {
+        counts[idnr[i] - '0']++;
+    }
+    for(i = 0; i < 10; i++) {
+        if(counts[i] > 3 || (counts[i] > 1 && repeated != -1)) {
+            return ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+        }
+        if(counts[i] > 1) {
+            repeated = i;
+        }
+    }
+    if(repeated == -1) {
+        return ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+    }
+    if(counts[repeated] == 3) {
+        for(i = 0; i < 8; i++) {
+            if(idnr[i] - '0' == repeated && idnr[i + 1] == idnr[i] && idnr[i + 2] == idnr[i]) {
+                return ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+            }
+        }
+    }
+
+    for(i = 0; i < 10; i++) {
+        sum = (idnr[i] - '0' + product) % 10;
+        if(sum == 0) {
+            sum = 10;
+        }
+        product = (sum * 2) % 11;
+    }
+    sum = 11 - product;
+    if(sum == 10) {
+        sum = 0;
+    }
+
+    return sum == idnr[10] - '0' ? ERIC_OK : ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+}
+
+static void eric_validation_run(eric_validation_batch *batch, eric_instance *inst)
+{
+    uint32_t from, to, i;
+
+    for(;;) {
+        pthread_mutex_lock(&batch->mutex);
+        from = batch->next;
+        to = MIN(from + ERIC_VALIDATION_CHUNK, batch->count);
+        batch->next = to;
+        pthread_mutex_unlock(&batch->mutex);
+
+        if(from >= to) {
+            return;
+        }
+        for(i = from; i < to; i++) {
+            batch->codes[i] = batch->validator(inst, ZSTR_VAL(batch->values[i]));
+        }
+    }
+}
+
+static void *eric_validation_worker(void *arg)
+{
+    eric_validation_batch *batch = arg;
+    eric_instance *inst = eric_instance_acquire_ex(0);
+
+    if(inst != NULL) {
+        eric_validation_run(batch, inst);
+        eric_instance_release(inst);
+    }
+
+    return NULL;
+}
+
+static void eric_validate_batch(
+    INTERNAL_FUNCTION_PARAMETERS,
+    eric_validator validator,
+    eric_native_validator native
+) {
+    HashTable *values;
+    zend_long threads = 1;
+    eric_validation_batch batch;
+    pthread_t workers[64];
+    int workerCount = 0, w;
+    zend_ulong h;
+    zend_string *key;
+    zval *value;
+    uint32_t i;
+
+    ZEND_PARSE_PARAMETERS_START(1,2)
+        Z_PARAM_ARRAY_HT(values)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(threads)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(native != NULL && INI_INT("eric.native_validators")) {
+        array_init_size(return_value, zend_hash_num_elements(values));
+        ZEND_HASH_FOREACH_KEY_VAL(values, h, key, value) {
+            zend_string *str = zval_get_string(value);
+            zval code;
+
+            /* libericapi takes C strings, so the value ends at the first NUL as it would there */
+            ZVAL_LONG(&code, native(ZSTR_VAL(str), strlen(ZSTR_VAL(str))));
+            if(key != NULL) {
+                zend_hash_update(Z_ARRVAL_P(return_value), key, &code);
+            } else {
+                zend_hash_index_update(Z_ARRVAL_P(return_value), h, &code);
+            }
+            zend_string_release(str);
+        } ZEND_HASH_FOREACH_END();
+
+        return;
+    }
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    memset(&batch, 0, sizeof(eric_validation_batch));
+    batch.validator = validator;
+    batch.count = zend_hash_num_elements(values);
+    batch.values = safe_emalloc(batch.count, sizeof(zend_string *), 0);
+    batch.codes = safe_emalloc(batch.count, sizeof(zend_long), 0);
+    pthread_mutex_init(&batch.mutex, NULL);
+
+    i = 0;
+    ZEND_HASH_FOREACH_VAL(values, value) {
+        batch.values[i++] = zval_get_string(value);
+    } ZEND_HASH_FOREACH_END();
+
+    /* the singlethreading api must not be entered concurrently */
+    if(eric_mt_enabled && threads > 1) {
+        threads = MIN(threads - 1, MIN(eric_pool_size, 64));
+        threads = MIN(threads, (zend_long) ((batch.count + ERIC_VALIDATION_CHUNK - 1) / ERIC_VALIDATION_CHUNK) - 1);
+        for(w = 0; w < threads; w++) {
+            if(pthread_create(&workers[workerCount], NULL, eric_validation_worker, &batch) == 0) {
+                workerCount++;
+            }
+        }
+    }
+    eric_validation_run(&batch, inst);
+    for(w = 0; w < workerCount; w++) {
+        pthread_join(workers[w], NULL);
+    }
+
+    array_init_size(return_value, batch.count);
+    i = 0;
+    ZEND_HASH_FOREACH_KEY_VAL(values, h, key, value) {
+        zval code;
+
+        ZVAL_LONG(&code, batch.codes[i]);
+        if(key != NULL) {
+            zend_hash_update(Z_ARRVAL_P(return_value), key, &code);
+        } else {
+            zend_hash_index_update(Z_ARRVAL_P(return_value), h, &code);
+        }
+        zend_string_release(batch.values[i++]);
+    } ZEND_HASH_FOREACH_END();
+
+    pthread_mutex_destroy(&batch.mutex);
+    efree(batch.values);
+    efree(batch.codes);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_validate_batch, 1)
+    ZEND_ARG_INFO(0, values)
+    ZEND_ARG_INFO(0, threads)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(eric_validate_ibans)
+{
+    eric_validate_batch(INTERNAL_FUNCTION_PARAM_PASSTHRU, eric_validate_iban, eric_native_iban);
+}
+
+PHP_FUNCTION(eric_validate_bics)
+{
+    eric_validate_batch(INTERNAL_FUNCTION_PARAM_PASSTHRU, eric_validate_bic, eric_native_bic);
+}
+
+PHP_FUNCTION(eric_validate_tax_ids)
+{
+    eric_validate_batch(INTERNAL_FUNCTION_PARAM_PASSTHRU, eric_validate_tax_id, eric_native_tax_id);
+}
+
+PHP_FUNCTION(eric_validate_tax_numbers)
+{
+    eric_validate_batch(INTERNAL_FUNCTION_PARAM_PASSTHRU, eric_validate_tax_number, NULL);
+}
+
+PHP_FUNCTION(eric_validate_tax_office_numbers)
+{
+    eric_validate_batch(INTERNAL_FUNCTION_PARAM_PASSTHRU, eric_validate_tax_office_number, NULL);
+}
+
+/* schema and plausibility check without sending, identical documents are answered from the check cache */
+PHP_FUNCTION(eric_check_xml)
+{
+    char *xml;
+    size_t xmlLength;
+    char *dataType;
+    size_t dataTypeLength;
+    zval *errorText = NULL;
+    zend_bool useCache = 1;
+    zend_string *text = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(2,4)
+        Z_PARAM_STRING(xml, xmlLength)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ZVAL(errorText)
+        Z_PARAM_BOOL(useCache)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        RETURN_FALSE;
+    }
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    ERIC_G(errCode) = eric_check_xml(inst, xml, xmlLength, dataType, dataTypeLength, useCache, &text);
+    if(errorText != NULL) {
+        ZEND_TRY_ASSIGN_REF_STR(errorText, text);
+    } else {
+        zend_string_release(text);
+    }
+
+    RETURN_BOOL(ERIC_G(errCode) == ERIC_OK);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_check_xml, 0)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, dataTypeVersion)
+    ZEND_ARG_INFO(1, error_text)
+    ZEND_ARG_INFO(0, use_cache)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(eric_check_cache_flush)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    pthread_mutex_lock(&eric_checks.mutex);
+    int flushed = eric_check_cache_flush_locked();
+    pthread_mutex_unlock(&eric_checks.mutex);
+
+    RETURN_LONG(flushed);
+}
+
+PHP_FUNCTION(eric_check_cache_stats)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    array_init(return_value);
+
+    pthread_mutex_lock(&eric_checks.mutex);
+    add_assoc_long(return_value, "hits", eric_checks.hits);
+    add_assoc_long(return_value, "misses", eric_checks.misses);
+    add_assoc_long(return_value, "entries", zend_hash_num_elements(&eric_checks.entries));
+    pthread_mutex_unlock(&eric_checks.mutex);
+}
+
+PHP_FUNCTION(eric_transfer)
+{
+    if(lericapi != NULL) {
+        char *certPath;
+        size_t certLength;
+        char *pin;
+        size_t pinLength;
+        char *dataType; /* Est_2019 */
+        size_t dataTypeVersionLength;
+        char *xml;
+        size_t xmlLength;
+        zval *serverResponse;
+        zval *serverAnswer = NULL;
+
+        ZEND_PARSE_PARAMETERS_START(5,6)
+            Z_PARAM_ZVAL(serverResponse)
+            Z_PARAM_STRING(dataType, dataTypeVersionLength)
+            Z_PARAM_STRING(xml, xmlLength)
+            Z_PARAM_STRING(certPath, certLength)
+            Z_PARAM_STRING(pin, pinLength)
+            Z_PARAM_OPTIONAL
+            Z_PARAM_ZVAL(serverAnswer)
+        ZEND_PARSE_PARAMETERS_END();
+
+        eric_instance *inst = eric_request_instance();
+        if(inst == NULL) {
+            RETURN_FALSE;
+        }
+
+        eric_job job;
+        memset(&job, 0, sizeof(eric_job));
+        job.dataType = dataType;
+        job.xml = xml;
+        job.flags = ERIC_SENDE;
+        job.certPath = certPath;
+        job.pin = pin;
+        job.parseAnswer = serverAnswer != NULL;
+
+        eric_job_run(inst, &job);
+        ERIC_G(errCode) = job.err;
+        memcpy(&ERIC_G(lastTimings), &job.timings, sizeof(eric_timings));
+
+        if(job.serverResponse != NULL) {
+            ZEND_TRY_ASSIGN_REF_STR(serverResponse, job.serverResponse);
+        }
+        if(serverAnswer != NULL) {
+            eric_job_assign_answer(&job, serverAnswer);
+        }
+        if(job.err == ERIC_OK && job.returnXml != NULL) {
+            RETURN_STR(job.returnXml);
+        }
+        if(job.returnXml != NULL) {
+            zend_string_release(job.returnXml);
+        }
+    } else {
+        ERIC_G(errCode) = -1;
+    }
+
+    RETURN_FALSE;
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_transfer, 1)
+    ZEND_ARG_INFO(1, server_response)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+    ZEND_ARG_INFO(0, eric_certificate_pin)
+    ZEND_ARG_INFO(1, server_answer)
+ZEND_END_ARG_INFO()
+
+/* returns the return xml whenever eric produced one, check eric_get_error_code() for ERIC_OK, hints or check errors */
+PHP_FUNCTION(eric_process)
+{
+    zval *serverResponse;
+    char *dataType;
+    size_t dataTypeLength;
+    char *xml;
+    size_t xmlLength;
+    zend_long flags;
+    char *certPath = NULL;
+    size_t certLength = 0;
+    char *pin = "";
+    size_t pinLength = 0;
+    char *pdfName = NULL;
+    size_t pdfNameLength = 0;
+    zval *serverAnswer = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(4,8)
+        Z_PARAM_ZVAL(serverResponse)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_STRING(xml, xmlLength)
+        Z_PARAM_LONG(flags)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STRING_OR_NULL(certPath, certLength)
+        Z_PARAM_STRING(pin, pinLength)
+        Z_PARAM_STRING_OR_NULL(pdfName, pdfNameLength)
+        Z_PARAM_ZVAL(serverAnswer)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        RETURN_FALSE;
+    }
+    if(flags == 0) {
+        ERIC_G(errCode) = ERIC_GLOBAL_UNGUELTIGER_PARAMETER;
+        RETURN_FALSE;
+    }
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    eric_job job;
+    memset(&job, 0, sizeof(eric_job));
+    job.dataType = dataType;
+    job.xml = xml;
+    job.flags = (uint32_t) flags;
+    job.certPath = certPath;
+    job.pin = pin;
+    job.pdfName = pdfName;
+    job.parseAnswer = serverAnswer != NULL;
+
+    eric_job_run(inst, &job);
+    ERIC_G(errCode) = job.err;
+    memcpy(&ERIC_G(lastTimings), &job.timings, sizeof(eric_timings));
+
+    if(job.serverResponse != NULL) {
+        ZEND_TRY_ASSIGN_REF_STR(serverResponse, job.serverResponse);
+    }
+    if(serverAnswer != NULL) {
+        eric_job_assign_answer(&job, serverAnswer);
+    }
+    if(job.returnXml != NULL && (ZSTR_LEN(job.returnXml) > 0 || job.err == ERIC_OK)) {
+        RETURN_STR(job.returnXml);
+    }
+    if(job.returnXml != NULL) {
+        zend_string_release(job.returnXml);
+    }
+
+    RETURN_FALSE;
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_process, 1)
+    ZEND_ARG_INFO(1, server_response)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, flags)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+    ZEND_ARG_INFO(0, eric_certificate_pin)
+    ZEND_ARG_INFO(0, pdf_name)
+    ZEND_ARG_INFO(1, server_answer)
+ZEND_END_ARG_INFO()
+
+/* xml input that is either mapped from a regular file or copied from a stream */
+typedef struct _eric_xml_source {
+    char *map;
+    size_t mapLength;
+    zend_string *copy;
+} eric_xml_source;
+
+/* maps size + 1 bytes so the xml is NUL terminated: past eof the kernel and the reserve are zero filled */
+static int eric_xml_source_map(eric_xml_source *src, int fd)
+{
+    struct stat st;
+    char *reserve;
+
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return FAILURE;
+    }
+    src->mapLength = st.st_size + 1;
+    reserve = mmap(NULL, src->mapLength, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(reserve == MAP_FAILED) {
+        return FAILURE;
+    }
+    if(st.st_size > 0 && mmap(reserve, st.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(reserve, src->mapLength);
+
+        return FAILURE;
+    }
+    madvise(reserve, src->mapLength, MADV_SEQUENTIAL);
+    src->map = reserve;
+
+    return SUCCESS;
+}
+
+static const char *eric_xml_source_open(eric_xml_source *src, zval *source)
+{
+    php_stream *stream;
+    int fd;
+
+    memset(src, 0, sizeof(eric_xml_source));
+
+    if(Z_TYPE_P(source) == IS_RESOURCE) {
+        php_stream_from_zval_no_verify(stream, source);
+        if(stream == NULL) {
+            return NULL;
+        }
+        if(php_stream_is_stdio(stream)
+            && php_stream_tell(stream) == 0
+            && php_stream_cast(stream, PHP_STREAM_AS_FD | PHP_STREAM_CAST_INTERNAL, (void **) &fd, 0) == SUCCESS
+            && eric_xml_source_map(src, fd) == SUCCESS
+        ) {
+            return src->map;
+        }
+
+        /* pipes, sockets, wrappers */
+        src->copy = php_stream_copy_to_mem(stream, PHP_STREAM_COPY_ALL, 0);
+
+        return src->copy != NULL ? ZSTR_VAL(src->copy) : "";
+    }
+
+    if(Z_TYPE_P(source) != IS_STRING
+        || CHECK_NULL_PATH(Z_STRVAL_P(source), Z_STRLEN_P(source))
+        || php_check_open_basedir(Z_STRVAL_P(source)) != 0
+    ) {
+        return NULL;
+    }
+    fd = open(Z_STRVAL_P(source), O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        return NULL;
+    }
+    if(eric_xml_source_map(src, fd) != SUCCESS) {
+        close(fd);
+
+        return NULL;
+    }
+    close(fd); /* the mapping keeps the file */
+
+    return src->map;
+}
+
+static void eric_xml_source_close(eric_xml_source *src)
+{
+    if(src->map != NULL) {
+        munmap(src->map, src->mapLength);
+    }
+    if(src->copy != NULL) {
+        zend_string_release(src->copy);
+    }
+}
+
+/* structured server answer for a server_response kept from an earlier transfer */
+PHP_FUNCTION(eric_parse_server_answer)
+{
+    char *xml;
+    size_t xmlLength;
+    zend_string *parts[ERIC_ANSWER_PARTS];
+
+    ZEND_PARSE_PARAMETERS_START(1,1)
+        Z_PARAM_STRING(xml, xmlLength)
+    ZEND_PARSE_PARAMETERS_END();
 
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        RETURN_FALSE;
+    }
 
-PHP_MINIT_FUNCTION(eric)
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    ERIC_G(errCode) = eric_server_answer(inst, xml, parts, 0);
+    if(ERIC_G(errCode) != ERIC_OK) {
+        RETURN_FALSE;
+    }
+
+    eric_server_answer_to_array(parts, return_value);
+    eric_server_answer_free(parts, 0);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_parse_server_answer, 0)
+    ZEND_ARG_INFO(0, server_response)
+ZEND_END_ARG_INFO()
+
+/* like eric_process, but the xml comes from a file path or stream and is mapped instead of copied */
+PHP_FUNCTION(eric_transfer_file)
 {
-    lericapi = dlopen("/home/jhoopmann/projects/eric-php-extension/lib/libericapi.so", RTLD_NOW);
-    if(!lericapi) {
-        php_log_err("cant dlopen lericapi\n");
-        
-        return FAILURE;
+    zval *serverResponse;
+    char *dataType;
+    size_t dataTypeLength;
+    zval *source;
+    char *certPath = NULL;
+    size_t certLength = 0;
+    char *pin = "";
+    size_t pinLength = 0;
+    char *pdfName = NULL;
+    size_t pdfNameLength = 0;
+    zend_long flags = ERIC_SENDE;
+    zval *serverAnswer = NULL;
+    eric_xml_source src;
+
+    ZEND_PARSE_PARAMETERS_START(3,8)
+        Z_PARAM_ZVAL(serverResponse)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_ZVAL(source)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(flags)
+        Z_PARAM_STRING_OR_NULL(certPath, certLength)
+        Z_PARAM_STRING(pin, pinLength)
+        Z_PARAM_STRING_OR_NULL(pdfName, pdfNameLength)
+        Z_PARAM_ZVAL(serverAnswer)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        RETURN_FALSE;
+    }
+    if(flags == 0) {
+        ERIC_G(errCode) = ERIC_GLOBAL_UNGUELTIGER_PARAMETER;
+        RETURN_FALSE;
     }
 
-    pEricInitialisiere = dlsym(lericapi, "EricInitialisiere");
-    pEricBeende = dlsym(lericapi, "EricBeende");
-    pEricChangePassword = dlsym(lericapi, "EricChangePassword");
-    pEricPruefeBuFaNummer = dlsym(lericapi, "EricPruefeBuFaNummer");
-    pEricBearbeiteVorgang = dlsym(lericapi, "EricBearbeiteVorgang");
-    pEricCheckXML = dlsym(lericapi, "EricCheckXML");
-    pEricCloseHandleToCertificate = dlsym(lericapi, "EricClosehandleToCertificate");
-    pEricCreateKey = dlsym(lericapi, "EricCreateKey");
-    pEricCreateTH = dlsym(lericapi, "EricCreateTH");
-    pEricDekodiereDaten = dlsym(lericapi, "EricDekodiereDaten");
-    pEricEinstellungAlleZuruecksetzen = dlsym(lericapi, "EricEinstellungAlleZuruecksetzen");
-    pEricEinstellungLesen = dlsym(lericapi, "EricEinstellungLesen");
-    pEricEinstellungSetzen = dlsym(lericapi, "EricEinstellungSetzen");
-    pEricEinstellungZuruecksetzen = dlsym(lericapi, "EricEinstellungZuruecksetzen");
-    pEricEntladePlugins = dlsym(lericapi, "EricEntladePlugins");
-    pEricFormatStNr = dlsym(lericapi, "EricFormatStNr");
-    pEricGetAuswahlListen = dlsym(lericapi, "EricGetAuswahlListen");
-    pEricGetErrormessagesFromXMLAnswer = dlsym(lericapi, "EricGetErrormessagesFromXMLAnswer");
-    pEricGetHandleToCertificate = dlsym(lericapi, "EricGetHandleToCertificate");
-    pEricGetPinStatus = dlsym(lericapi, "EricGetPinStatus");
-    pEricGetPublicKey = dlsym(lericapi, "EricGetPublicKey");
-    pEricHoleFehlerText = dlsym(lericapi, "EricHoleFehlerText");
-    pEricHoleFinanzaemter = dlsym(lericapi, "EricHoleFinanzaemter");
-    pEricHoleFinanzamtLandNummern = dlsym(lericapi, "EricHoleFinanzamtLandNummern");
-    pEricHoleFinanzamtsdaten = dlsym(lericapi, "EricHoleFinanzamtsdaten");
-    pEricHoleTestfinanzaemter = dlsym(lericapi, "EricHoleTestfinanzaemter");
-    pEricHoleZertifikatEigenschaften = dlsym(lericapi, "EricHoleZertifikatEigenschaften");
-    pEricHoleZertifikatFingerabdruck = dlsym(lericapi, "EricHoleZertifikatFingerabdruck");
-    pEricMakeElsterStnr = dlsym(lericapi, "EricMakeElsterStnr");
-    pEricPruefeBIC = dlsym(lericapi, "EricPruefeBIC");
-    pEricPruefeIBAN = dlsym(lericapi, "EricPruefeIBAN");
-    pEricPruefeSteuernummer = dlsym(lericapi, "EricPruefeSteuernummer");
-    pEricPruefeIdentifikationsMerkmal = dlsym(lericapi, "EricPruefeIdentifikationsMerkmal");
-    pEricPruefeZertifikatPin = dlsym(lericapi, "EricPruefeZertifikatPin");
-    pEricRegistriereFortschrittCallback = dlsym(lericapi, "EricRegistriereFortschrittCallback");
-    pEricRegistriereGlobalenFortschrittCallback = dlsym(lericapi, "EricRegistriereGlobalenFortschrittCallback");
-    pEricRegistriereLogCallback = dlsym(lericapi, "EricRegistriereLogCallback");
-    pEricRueckgabepufferErzeugen = dlsym(lericapi, "EricRueckgabepufferErzeugen");
-    pEricRueckgabepufferFreigeben = dlsym(lericapi, "EricRueckgabepufferFreigeben");
-    pEricRueckgabepufferInhalt = dlsym(lericapi, "EricRueckgabepufferInhalt");
-    pEricRueckgabepufferLaenge = dlsym(lericapi, "EricRueckgabepufferLaenge");
-    pEricSystemCheck = dlsym(lericapi, "EricSystemCheck");
-    pEricVersion = dlsym(lericapi, "EricVersion");
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    eric_job job;
+    memset(&job, 0, sizeof(eric_job));
+    job.xml = eric_xml_source_open(&src, source);
+    if(job.xml == NULL) {
+        ERIC_G(errCode) = ERIC_IO_FEHLER;
+        RETURN_FALSE;
+    }
+    job.dataType = dataType;
+    job.flags = (uint32_t) flags;
+    job.certPath = certPath;
+    job.pin = pin;
+    job.pdfName = pdfName;
+    job.parseAnswer = serverAnswer != NULL;
+
+    eric_job_run(inst, &job);
+    eric_xml_source_close(&src);
+    ERIC_G(errCode) = job.err;
+    memcpy(&ERIC_G(lastTimings), &job.timings, sizeof(eric_timings));
+
+    if(job.serverResponse != NULL) {
+        ZEND_TRY_ASSIGN_REF_STR(serverResponse, job.serverResponse);
+    }
+    if(serverAnswer != NULL) {
+        eric_job_assign_answer(&job, serverAnswer);
+    }
+    if(job.returnXml != NULL && (ZSTR_LEN(job.returnXml) > 0 || job.err == ERIC_OK)) {
+        RETURN_STR(job.returnXml);
+    }
+    if(job.returnXml != NULL) {
+        zend_string_release(job.returnXml);
+    }
+
+    RETURN_FALSE;
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_transfer_file, 1)
+    ZEND_ARG_INFO(1, server_response)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml_file)
+    ZEND_ARG_INFO(0, flags)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+    ZEND_ARG_INFO(0, eric_certificate_pin)
+    ZEND_ARG_INFO(0, pdf_name)
+    ZEND_ARG_INFO(1, server_answer)
+ZEND_END_ARG_INFO()
+
+static int eric_sink_is_path(zval *sink)
+{
+    return Z_TYPE_P(sink) == IS_STRING;
+}
+
+/* null discards, a path is opened for writing, anything else goes to eric_sink_write(); returns bytes */
+static zend_long eric_output_sink(eric_instance *inst, EricRueckgabepufferHandle buf, zval *sink)
+{
+    const char *data = ERIC_CALL(inst, RueckgabepufferInhalt, buf);
+    size_t len = ERIC_CALL(inst, RueckgabepufferLaenge, buf);
+    php_stream *stream;
+    int ret;
+
+    if(sink == NULL || Z_TYPE_P(sink) == IS_NULL || len == 0) {
+        return len;
+    }
+    if(eric_sink_is_path(sink)) {
+        stream = php_stream_open_wrapper(Z_STRVAL_P(sink), "wb", REPORT_ERRORS, NULL);
+        if(stream == NULL) {
+            return -1;
+        }
+        ret = php_stream_write(stream, data, len) == len ? SUCCESS : FAILURE;
+        php_stream_close(stream);
+    } else {
+        ret = eric_sink_write(sink, data, len);
+    }
+
+    return ret == SUCCESS ? (zend_long) len : -1;
+}
+
+/* return xml and server response go straight from the eric buffers into the sinks, php only gets lengths */
+PHP_FUNCTION(eric_transfer_to)
+{
+    zval *returnSink;
+    zval *responseSink;
+    char *dataType;
+    size_t dataTypeLength;
+    char *xml;
+    size_t xmlLength;
+    zend_long flags = ERIC_SENDE;
+    char *certPath = NULL;
+    size_t certLength = 0;
+    char *pin = "";
+    size_t pinLength = 0;
+    char *pdfName = NULL;
+    size_t pdfNameLength = 0;
+    zend_long returnLength = 0, responseLength = 0;
+
+    ZEND_PARSE_PARAMETERS_START(4,8)
+        Z_PARAM_ZVAL_OR_NULL(returnSink)
+        Z_PARAM_ZVAL_OR_NULL(responseSink)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_STRING(xml, xmlLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(flags)
+        Z_PARAM_STRING_OR_NULL(certPath, certLength)
+        Z_PARAM_STRING(pin, pinLength)
+        Z_PARAM_STRING_OR_NULL(pdfName, pdfNameLength)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        RETURN_FALSE;
+    }
+    if(returnSink != NULL && Z_TYPE_P(returnSink) != IS_STRING && !eric_sink_valid(returnSink)) {
+        zend_argument_value_error(1, "must be a path, stream, callable or null");
+        RETURN_THROWS();
+    }
+    if(responseSink != NULL && Z_TYPE_P(responseSink) != IS_STRING && !eric_sink_valid(responseSink)) {
+        zend_argument_value_error(2, "must be a path, stream, callable or null");
+        RETURN_THROWS();
+    }
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    eric_job job;
+    memset(&job, 0, sizeof(eric_job));
+    job.dataType = dataType;
+    job.xml = xml;
+    job.flags = (uint32_t) flags;
+    job.certPath = certPath;
+    job.pin = pin;
+    job.pdfName = pdfName;
+    job.keepBuffers = 1;
+
+    eric_job_run(inst, &job);
+    ERIC_G(errCode) = job.err;
+    memcpy(&ERIC_G(lastTimings), &job.timings, sizeof(eric_timings));
+
+    if(job.returnBuffer != NULL) {
+        returnLength = eric_output_sink(inst, job.returnBuffer, returnSink);
+        eric_buffer_release(inst, job.returnBuffer);
+    }
+    if(job.responseBuffer != NULL) {
+        responseLength = eric_output_sink(inst, job.responseBuffer, responseSink);
+        eric_buffer_release(inst, job.responseBuffer);
+    }
+    if(returnLength < 0 || responseLength < 0) {
+        ERIC_G(errCode) = ERIC_IO_FEHLER;
+    }
+
+    array_init_size(return_value, 3);
+    add_assoc_long(return_value, "code", ERIC_G(errCode));
+    add_assoc_long(return_value, "return_xml_length", returnLength);
+    add_assoc_long(return_value, "server_response_length", responseLength);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_transfer_to, 0)
+    ZEND_ARG_INFO(0, return_xml_sink)
+    ZEND_ARG_INFO(0, server_response_sink)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, flags)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+    ZEND_ARG_INFO(0, eric_certificate_pin)
+    ZEND_ARG_INFO(0, pdf_name)
+ZEND_END_ARG_INFO()
+
+/* a job description array from php, strings are held until the batch is done */
+typedef struct _eric_batch_item {
+    eric_job job;
+    zend_string *key;
+    zend_ulong h;
+    zend_string *strings[5];
+} eric_batch_item;
+
+typedef struct _eric_transfer_batch {
+    eric_batch_item *items;
+    uint32_t count;
+    uint32_t next; /* next item to run */
+    uint32_t *done; /* item indices in completion order */
+    uint32_t doneCount;
+    int activeWorkers;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} eric_transfer_batch;
+
+static const char *eric_batch_item_string(eric_batch_item *item, int slot, HashTable *spec, const char *name)
+{
+    zval *zv = zend_hash_str_find(spec, name, strlen(name));
+
+    if(zv == NULL || Z_TYPE_P(zv) == IS_NULL) {
+        return NULL;
+    }
+    item->strings[slot] = zval_get_string(zv);
+
+    return ZSTR_VAL(item->strings[slot]);
+}
+
+/* keys: data_type, xml, flags (default ERIC_SENDE), cert, pin, pdf_name, parse_answer */
+static void eric_batch_item_init(eric_batch_item *item, zval *spec)
+{
+    zval *flags, *parseAnswer;
+
+    memset(item, 0, sizeof(eric_batch_item));
+    item->job.persistent = 1;
+    if(Z_TYPE_P(spec) != IS_ARRAY) {
+        return; /* runs into ERIC_GLOBAL_NULL_PARAMETER */
+    }
+
+    item->job.dataType = eric_batch_item_string(item, 0, Z_ARRVAL_P(spec), "data_type");
+    item->job.xml = eric_batch_item_string(item, 1, Z_ARRVAL_P(spec), "xml");
+    item->job.certPath = eric_batch_item_string(item, 2, Z_ARRVAL_P(spec), "cert");
+    item->job.pin = eric_batch_item_string(item, 3, Z_ARRVAL_P(spec), "pin");
+    item->job.pdfName = eric_batch_item_string(item, 4, Z_ARRVAL_P(spec), "pdf_name");
+    flags = zend_hash_str_find(Z_ARRVAL_P(spec), "flags", sizeof("flags") - 1);
+    item->job.flags = flags != NULL ? (uint32_t) zval_get_long(flags) : ERIC_SENDE;
+    parseAnswer = zend_hash_str_find(Z_ARRVAL_P(spec), "parse_answer", sizeof("parse_answer") - 1);
+    item->job.parseAnswer = parseAnswer != NULL && zend_is_true(parseAnswer);
+}
+
+static void eric_batch_item_destroy(eric_batch_item *item)
+{
+    int i;
+
+    for(i = 0; i < 5; i++) {
+        if(item->strings[i] != NULL) {
+            zend_string_release(item->strings[i]);
+        }
+    }
+}
+
+/* copies a string produced off the request thread into request memory */
+static void eric_job_result_string(zval *result, const char *name, zend_string *str, int consume)
+{
+    if(str == NULL) {
+        add_assoc_null(result, name);
+
+        return;
+    }
+    add_assoc_stringl(result, name, ZSTR_VAL(str), ZSTR_LEN(str));
+    if(consume) {
+        zend_string_release_ex(str, 1);
+    }
+}
+
+/* the parsed server answer as name, null if there was no answer to parse */
+static void eric_job_answer(eric_job *job, zval *result, const char *name, int consume)
+{
+    zval zv;
+
+    if(job->answerErr == ERIC_OK) {
+        eric_server_answer_to_array(job->answer, &zv);
+        add_assoc_zval(result, name, &zv);
+    } else {
+        add_assoc_null(result, name);
+    }
+    if(consume) {
+        eric_server_answer_free(job->answer, job->persistent);
+    }
+}
+
+/* error text, eric_error_info(), attempts and timings of one result */
+static void eric_result_add_state(zval *result, int code, zend_string *errorText, int attempts, eric_timings *timings)
+{
+    const eric_error_info *info = eric_error_lookup(code);
+    zval zv;
+
+    if(errorText != NULL) {
+        ZVAL_INTERNED_STR(&zv, errorText);
+        add_assoc_zval(result, "error", &zv);
+    } else {
+        add_assoc_null(result, "error");
+    }
+    if(info != NULL) {
+        eric_error_info_to_array(info, &zv);
+        add_assoc_zval(result, "error_info", &zv);
+    } else {
+        add_assoc_null(result, "error_info");
+    }
+    add_assoc_long(result, "attempts", attempts);
+    eric_timings_to_array(timings, &zv);
+    add_assoc_zval(result, "timings", &zv);
+}
+
+/* with consume the persistent results are freed, otherwise the job keeps them */
+static void eric_job_result(eric_job *job, zval *result, int consume)
+{
+    array_init_size(result, 7);
+    add_assoc_long(result, "code", job->err);
+    eric_job_result_string(result, "return_xml", job->returnXml, consume);
+    eric_job_result_string(result, "server_response", job->serverResponse, consume);
+    eric_result_add_state(result, job->err, job->errorText, job->attempts, &job->timings);
+    if(job->parseAnswer) {
+        eric_job_answer(job, result, "server", consume);
+    }
+    if(consume) {
+        job->returnXml = job->serverResponse = NULL;
+    }
+}
+
+static void eric_transfer_batch_complete(eric_transfer_batch *batch, uint32_t i)
+{
+    pthread_mutex_lock(&batch->mutex);
+    batch->done[batch->doneCount++] = i;
+    pthread_cond_signal(&batch->cond);
+    pthread_mutex_unlock(&batch->mutex);
+}
+
+static void *eric_transfer_batch_worker(void *arg)
+{
+    eric_transfer_batch *batch = arg;
+    eric_instance *inst = eric_instance_acquire_ex(0); /* never wait on the instance the request may hold */
+    uint32_t i;
+
+    while(inst != NULL) {
+        pthread_mutex_lock(&batch->mutex);
+        i = batch->next < batch->count ? batch->next++ : batch->count;
+        pthread_mutex_unlock(&batch->mutex);
+
+        if(i >= batch->count) {
+            break;
+        }
+        eric_job_run(inst, &batch->items[i].job);
+        eric_transfer_batch_complete(batch, i);
+    }
+    eric_instance_release(inst);
+
+    pthread_mutex_lock(&batch->mutex);
+    batch->activeWorkers--;
+    pthread_cond_signal(&batch->cond);
+    pthread_mutex_unlock(&batch->mutex);
+
+    return NULL;
+}
+
+typedef void (*eric_batch_deliver)(eric_batch_item *item, void *ctx);
+
+/* runs all items with up to concurrency workers, deliver is called on the request thread in completion order */
+static void eric_transfer_batch_execute(
+    eric_transfer_batch *batch,
+    zend_long concurrency,
+    eric_batch_deliver deliver,
+    void *ctx
+) {
+    pthread_t workers[64];
+    int workerCount = 0, w;
+    uint32_t i, delivered = 0;
+
+    batch->next = 0;
+    batch->doneCount = 0;
+    batch->activeWorkers = 0;
+    batch->done = safe_emalloc(batch->count, sizeof(uint32_t), 0);
+    pthread_mutex_init(&batch->mutex, NULL);
+    pthread_cond_init(&batch->cond, NULL);
+
+    /* the singlethreading api must not be entered concurrently */
+    if(eric_mt_enabled && concurrency > 1) {
+        concurrency = MIN(concurrency, MIN(eric_pool_size, 64));
+        concurrency = MIN(concurrency, (zend_long) batch->count);
+        for(w = 0; w < concurrency; w++) {
+            batch->activeWorkers++;
+            if(pthread_create(&workers[workerCount], NULL, eric_transfer_batch_worker, batch) == 0) {
+                workerCount++;
+            } else {
+                batch->activeWorkers--;
+            }
+        }
+    }
+
+    /* the request thread only runs jobs itself once no worker is left */
+    pthread_mutex_lock(&batch->mutex);
+    while(delivered < batch->count) {
+        if(delivered < batch->doneCount) {
+            i = batch->done[delivered++];
+            pthread_mutex_unlock(&batch->mutex);
+            deliver(&batch->items[i], ctx);
+            pthread_mutex_lock(&batch->mutex);
+            continue;
+        }
+        if(batch->activeWorkers == 0 && batch->next < batch->count) {
+            i = batch->next++;
+            pthread_mutex_unlock(&batch->mutex);
+
+            eric_instance *inst = eric_request_instance();
+            if(inst != NULL) {
+                eric_job_run(inst, &batch->items[i].job);
+            } else {
+                batch->items[i].job.err = ERIC_GLOBAL_FEHLER_INITIALISIERUNG;
+            }
+            eric_transfer_batch_complete(batch, i);
+            pthread_mutex_lock(&batch->mutex);
+            continue;
+        }
+        pthread_cond_wait(&batch->cond, &batch->mutex);
+    }
+    pthread_mutex_unlock(&batch->mutex);
+
+    for(w = 0; w < workerCount; w++) {
+        pthread_join(workers[w], NULL);
+    }
+    pthread_cond_destroy(&batch->cond);
+    pthread_mutex_destroy(&batch->mutex);
+    efree(batch->done);
+    batch->done = NULL;
+}
+
+typedef struct _eric_transfer_batch_ctx {
+    zval *results;
+    zend_fcall_info fci;
+    zend_fcall_info_cache fcc;
+} eric_transfer_batch_ctx;
+
+static void eric_transfer_batch_deliver(eric_batch_item *item, void *arg)
+{
+    eric_transfer_batch_ctx *ctx = arg;
+    zval result;
+
+    eric_job_result(&item->job, &result, 1);
+    if(ZEND_FCI_INITIALIZED(ctx->fci) && EG(exception) == NULL) {
+        zval args[2], retval;
+
+        ZVAL_COPY_VALUE(&args[0], &result);
+        if(item->key != NULL) {
+            ZVAL_STR(&args[1], item->key);
+        } else {
+            ZVAL_LONG(&args[1], item->h);
+        }
+        ctx->fci.retval = &retval;
+        ctx->fci.params = args;
+        ctx->fci.param_count = 2;
+        if(zend_call_function(&ctx->fci, &ctx->fcc) == SUCCESS) {
+            zval_ptr_dtor(&retval);
+        }
+    }
+    if(item->key != NULL) {
+        zend_hash_update(Z_ARRVAL_P(ctx->results), item->key, &result);
+    } else {
+        zend_hash_index_update(Z_ARRVAL_P(ctx->results), item->h, &result);
+    }
+}
+
+PHP_FUNCTION(eric_transfer_batch)
+{
+    HashTable *jobs;
+    zend_long concurrency = 4;
+    eric_transfer_batch_ctx ctx;
+    eric_transfer_batch batch;
+    uint32_t i;
+    zend_ulong h;
+    zend_string *key;
+    zval *spec;
+
+    ctx.fci = empty_fcall_info;
+    ctx.fcc = empty_fcall_info_cache;
+
+    ZEND_PARSE_PARAMETERS_START(1,3)
+        Z_PARAM_ARRAY_HT(jobs)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(concurrency)
+        Z_PARAM_FUNC_OR_NULL(ctx.fci, ctx.fcc)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        RETURN_FALSE;
+    }
+
+    memset(&batch, 0, sizeof(eric_transfer_batch));
+    batch.count = zend_hash_num_elements(jobs);
+    batch.items = safe_emalloc(batch.count, sizeof(eric_batch_item), 0);
+
+    i = 0;
+    ZEND_HASH_FOREACH_KEY_VAL(jobs, h, key, spec) {
+        eric_batch_item_init(&batch.items[i], spec);
+        batch.items[i].key = key;
+        batch.items[i].h = h;
+        i++;
+    } ZEND_HASH_FOREACH_END();
+
+    /* results are handed out as they complete */
+    array_init_size(return_value, batch.count);
+    ctx.results = return_value;
+    eric_transfer_batch_execute(&batch, concurrency, eric_transfer_batch_deliver, &ctx);
+
+    for(i = 0; i < batch.count; i++) {
+        eric_batch_item_destroy(&batch.items[i]);
+    }
+    efree(batch.items);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_transfer_batch, 0)
+    ZEND_ARG_INFO(0, jobs)
+    ZEND_ARG_INFO(0, concurrency)
+    ZEND_ARG_INFO(0, on_result)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(eric_transfer_async)
+{
+    char *dataType;
+    size_t dataTypeLength;
+    char *xml;
+    size_t xmlLength;
+    zend_long flags = ERIC_SENDE;
+    char *certPath = NULL;
+    size_t certLength = 0;
+    char *pin = "";
+    size_t pinLength = 0;
+    char *pdfName = NULL;
+    size_t pdfNameLength = 0;
+    zend_bool parseAnswer = 0;
+    eric_future *future;
+
+    ZEND_PARSE_PARAMETERS_START(2,7)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_STRING(xml, xmlLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(flags)
+        Z_PARAM_STRING_OR_NULL(certPath, certLength)
+        Z_PARAM_STRING(pin, pinLength)
+        Z_PARAM_STRING_OR_NULL(pdfName, pdfNameLength)
+        Z_PARAM_BOOL(parseAnswer)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(lericapi == NULL) {
+        ERIC_G(errCode) = -1;
+        RETURN_FALSE;
+    }
+
+    future = pecalloc(1, sizeof(eric_future), 1);
+    future->job.persistent = 1;
+    future->job.flags = (uint32_t) flags;
+    future->job.dataType = eric_future_string(future, 0, dataType);
+    future->job.xml = eric_future_string(future, 1, xml);
+    future->job.certPath = eric_future_string(future, 2, certPath);
+    future->job.pin = eric_future_string(future, 3, pin);
+    future->job.pdfName = eric_future_string(future, 4, pdfName);
+    future->job.parseAnswer = parseAnswer;
+    future->refcount = 1;
+    pthread_mutex_init(&future->mutex, NULL);
+    pthread_cond_init(&future->cond, NULL);
+
+    future->notifier = eric_async_notifier_get();
+    if(future->notifier != NULL) {
+        __atomic_add_fetch(&future->notifier->refcount, 1, __ATOMIC_RELAXED);
+    }
+
+    /* a worker waits for a free instance, so the request must not sit on one until RSHUTDOWN */
+    eric_request_instance_release(0);
+
+    /* the singlethreading api only runs on the request thread, the future is done right away;
+       so does a request whose session objects keep its instance, the worker could wait for it forever */
+    future->refcount++;
+    if(!eric_mt_enabled || ERIC_G(instance) != NULL || eric_async_submit(future) != SUCCESS) {
+        eric_instance *inst = eric_request_instance();
+
+        if(inst != NULL) {
+            eric_job_run(inst, &future->job);
+        } else {
+            future->job.err = ERIC_GLOBAL_FEHLER_INITIALISIERUNG;
+        }
+        eric_future_complete(future);
+        future->refcount--;
+    }
+
+    RETURN_RES(zend_register_resource(future, le_eric_future));
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_transfer_async, 0)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, flags)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+    ZEND_ARG_INFO(0, eric_certificate_pin)
+    ZEND_ARG_INFO(0, pdf_name)
+    ZEND_ARG_INFO(0, parse_answer)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(eric_poll)
+{
+    zval *zfuture;
+    eric_future *future;
+
+    ZEND_PARSE_PARAMETERS_START(1,1)
+        Z_PARAM_RESOURCE(zfuture)
+    ZEND_PARSE_PARAMETERS_END();
+
+    future = zend_fetch_resource(Z_RES_P(zfuture), "eric future", le_eric_future);
+    if(future == NULL) {
+        RETURN_THROWS();
+    }
+
+    RETURN_BOOL(__atomic_load_n(&future->done, __ATOMIC_ACQUIRE));
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_poll, 0)
+    ZEND_ARG_INFO(0, future)
+ZEND_END_ARG_INFO()
+
+/* result array like eric_transfer_batch, false on timeout; a negative timeout waits forever */
+PHP_FUNCTION(eric_await)
+{
+    zval *zfuture;
+    double timeout = -1;
+    eric_future *future;
+    struct timespec until;
+    int timedOut = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1,2)
+        Z_PARAM_RESOURCE(zfuture)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_DOUBLE(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    future = zend_fetch_resource(Z_RES_P(zfuture), "eric future", le_eric_future);
+    if(future == NULL) {
+        RETURN_THROWS();
+    }
+
+    if(!__atomic_load_n(&future->done, __ATOMIC_ACQUIRE)) {
+        eric_request_instance_release(0); /* do not block on the pool while holding an instance */
+
+        if(timeout >= 0) {
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_sec += (time_t) timeout;
+            until.tv_nsec += (long) ((timeout - (time_t) timeout) * 1e9);
+            if(until.tv_nsec >= 1000000000L) {
+                until.tv_sec++;
+                until.tv_nsec -= 1000000000L;
+            }
+        }
+        pthread_mutex_lock(&future->mutex);
+        while(!future->done && !timedOut) {
+            if(timeout < 0) {
+                pthread_cond_wait(&future->cond, &future->mutex);
+            } else {
+                timedOut = pthread_cond_timedwait(&future->cond, &future->mutex, &until) != 0;
+            }
+        }
+        timedOut = !future->done;
+        pthread_mutex_unlock(&future->mutex);
+    }
+    if(timedOut) {
+        RETURN_FALSE;
+    }
+
+    ERIC_G(errCode) = future->job.err;
+    eric_job_result(&future->job, return_value, 0);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_await, 0)
+    ZEND_ARG_INFO(0, future)
+    ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
 
-    return SUCCESS;
+/* readable whenever a future of this request completed, reading resets the counter */
+PHP_FUNCTION(eric_async_stream)
+{
+    eric_async_notifier *notifier;
+    php_stream *stream;
+    int fd;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    notifier = eric_async_notifier_get();
+    if(notifier == NULL || (fd = dup(notifier->fd)) < 0) {
+        RETURN_FALSE;
+    }
+    stream = php_stream_fopen_from_fd(fd, "r", NULL);
+    if(stream == NULL) {
+        close(fd);
+        RETURN_FALSE;
+    }
+
+    php_stream_to_zval(stream, return_value);
 }
 
-PHP_MSHUTDOWN_FUNCTION(eric)
+static int eric_spool_valid_id(const char *id, size_t len)
 {
-    if(lericapi) {
-        pEricBeende();
+    size_t i;
 
-        dlclose(lericapi); /* no need 4 nullset */ 
+    if(len != ERIC_SPOOL_ID_LENGTH) {
+        return 0;
     }
-    
-    return SUCCESS;
+    for(i = 0; i < len; i++) {
+        if(!ERIC_IS_DIGIT(id[i]) && !(id[i] >= 'a' && id[i] <= 'f')) {
+            return 0;
+        }
+    }
+
+    return 1;
 }
 
-PHP_RINIT_FUNCTION(eric)
+static void eric_spool_result_path(char *path, size_t size, const char *dir, const char *id)
+{
+    snprintf(path, size, "%s/results/%.*s", dir, ERIC_SPOOL_ID_LENGTH, id);
+}
+
+/* write to a temp file, sync, rename: a result either exists completely or not at all */
+static int eric_spool_write_result(const char *dir, const char *id, eric_job *job)
 {
-    eric_globals.errCode = 0;   
+    char path[MAXPATHLEN], tmp[MAXPATHLEN];
+    eric_spool_result_header header;
+    int fd, ret;
+
+    eric_spool_result_path(path, sizeof(path), dir, id);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if(fd < 0) {
+        return FAILURE;
+    }
+    memset(&header, 0, sizeof(header));
+    header.code = job->err;
+    header.attempts = job->attempts;
+    memcpy(&header.timings, &job->timings, sizeof(eric_timings));
+    header.returnXmlLength = job->returnXml != NULL ? ZSTR_LEN(job->returnXml) : 0;
+    header.serverResponseLength = job->serverResponse != NULL ? ZSTR_LEN(job->serverResponse) : 0;
 
-    certRequiresPin = 0;
+    ret = eric_spool_write_all(fd, (const char *) &header, sizeof(header));
+    if(ret == SUCCESS && header.returnXmlLength > 0) {
+        ret = eric_spool_write_all(fd, ZSTR_VAL(job->returnXml), header.returnXmlLength);
+    }
+    if(ret == SUCCESS && header.serverResponseLength > 0) {
+        ret = eric_spool_write_all(fd, ZSTR_VAL(job->serverResponse), header.serverResponseLength);
+    }
+    if(ret == SUCCESS && fdatasync(fd) != 0) {
+        ret = FAILURE;
+    }
+    close(fd);
 
-    eric_encryption_params.version = 2;
-    eric_encryption_params.pin = "";
-    eric_encryption_params.zertifikatHandle = NULL;    /* do not hold; open every time we send req */
+    if(ret != SUCCESS || rename(tmp, path) != 0) {
+        unlink(tmp);
 
-    eric_print_params.version = 2;
-    eric_print_params.vorschau = 0;
-    eric_print_params.ersteSeite = 0;
-    eric_print_params.duplexDruck = 0;
-    eric_print_params.pdfName = "eric_print.pdf";
-	eric_print_params.fussText = NULL;
+        return FAILURE;
+    }
 
     return SUCCESS;
 }
 
-PHP_FUNCTION(eric_init)
+static off_t eric_spool_read_offset(const char *dir)
 {
-    int err = pEricInitialisiere(
-        getenv("ERICAPI_LIB_PATH"), 
-        "/var/log/httpd"
-    );
-    if(err == ERIC_OK)  {
-        RETURN_BOOL(IS_TRUE);
+    char path[MAXPATHLEN], buf[32];
+    ssize_t n;
+    int fd;
+
+    snprintf(path, sizeof(path), "%s/journal.offset", dir);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        return 0;
     }
-    eric_globals.errCode = err;
-    RETURN_BOOL(IS_FALSE);
+    n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if(n <= 0) {
+        return 0;
+    }
+    buf[n] = '\0';
+
+    return (off_t) strtoll(buf, NULL, 10);
 }
 
-PHP_FUNCTION(eric_close)
+static int eric_spool_write_offset(const char *dir, off_t offset)
 {
-    int err = pEricBeende();
-    if(err == ERIC_OK) {
-        RETURN_BOOL(IS_TRUE);
+    char path[MAXPATHLEN], tmp[MAXPATHLEN], buf[32];
+    int fd, len, ret;
+
+    snprintf(path, sizeof(path), "%s/journal.offset", dir);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    len = snprintf(buf, sizeof(buf), "%lld\n", (long long) offset);
+
+    fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if(fd < 0) {
+        return FAILURE;
     }
-    eric_globals.errCode = err;
-    RETURN_BOOL(IS_FALSE);
+    ret = eric_spool_write_all(fd, buf, len);
+    if(ret == SUCCESS && fdatasync(fd) != 0) {
+        ret = FAILURE;
+    }
+    close(fd);
+
+    return ret == SUCCESS && rename(tmp, path) == 0 ? SUCCESS : FAILURE;
 }
 
-PHP_FUNCTION(eric_get_tax_office_country_numbers) /* je bundesland */
+/* skips a torn or corrupt region up to the next record magic */
+static off_t eric_spool_resync(int fd, off_t offset, off_t size)
 {
-    EricRueckgabepufferHandle buf = pEricRueckgabepufferErzeugen();
-    int ret = pEricHoleFinanzamtLandNummern(buf);
-    if(ret == ERIC_OK) {
-        int len = pEricRueckgabepufferLaenge(buf) +1;
-        
-        char *c = pEricRueckgabepufferInhalt(buf);
-        char const rbuf[len];
-        memcpy(
-            &rbuf[0],
-            &c[0],
-            len
-        );
+    char buf[64 * 1024];
+    ssize_t n;
+    char *hit;
 
-        pEricRueckgabepufferFreigeben(buf);
+    for(offset++; offset < size; offset += MAX(n - 3, 1)) {
+        n = pread(fd, buf, sizeof(buf), offset);
+        if(n < (ssize_t) sizeof(eric_spool_header)) {
+            return size;
+        }
+        hit = memmem(buf, n, ERIC_SPOOL_MAGIC, 4);
+        if(hit != NULL) {
+            return offset + (hit - buf);
+        }
+    }
 
-        RETURN_STRING(rbuf);
-    } 
+    return size;
+}
 
-    php_log_err("eric_get_tax_office_country_numbers error");
+/* a sent job whose result file could not be written yet */
+typedef struct _eric_spool_pending {
+    char id[ERIC_SPOOL_ID_LENGTH];
+    off_t offset;
+    eric_job job;                   /* only the results are kept */
+} eric_spool_pending;
 
-    RETURN_BOOL(IS_FALSE);
+typedef struct _eric_spool_ctx {
+    const char *dir;
+    char (*ids)[ERIC_SPOOL_ID_LENGTH];
+    off_t *offsets;                 /* journal offset of each loaded record */
+    eric_batch_item *items;
+    eric_spool_pending *pending;
+    uint32_t pendingCount;
+    zend_long delivered;
+} eric_spool_ctx;
+
+static void eric_spool_job_release(eric_job *job)
+{
+    if(job->returnXml != NULL) {
+        zend_string_release_ex(job->returnXml, 1);
+    }
+    if(job->serverResponse != NULL) {
+        zend_string_release_ex(job->serverResponse, 1);
+    }
+    job->returnXml = job->serverResponse = NULL;
+    eric_server_answer_free(job->answer, 1);
 }
 
-PHP_FUNCTION(eric_get_tax_offices_for_country_number)
+static void eric_spool_deliver(eric_batch_item *item, void *arg)
 {
-    const char *cn;
-    int cnlen;
-    ZEND_PARSE_PARAMETERS_START(1,1)
-        Z_PARAM_STRING(cn, cnlen)
-    ZEND_PARSE_PARAMETERS_END();
+    eric_spool_ctx *ctx = arg;
+    size_t i = item - ctx->items;
+    eric_spool_pending *pending;
 
-    EricRueckgabepufferHandle buf = pEricRueckgabepufferErzeugen();
-    
-    int ret = pEricHoleFinanzaemter(
-        cn,
-        buf
-    );
-    if(ret == ERIC_OK) {
-        char *b = pEricRueckgabepufferInhalt(buf);
-        int l = pEricRueckgabepufferLaenge(buf) +1;
-        const char rbuf[l];
-        memcpy(
-            &rbuf[0],
-            &b[0],
-            l
-        );
+    ctx->delivered++;
+    if(eric_spool_write_result(ctx->dir, ctx->ids[i], &item->job) == SUCCESS) {
+        eric_spool_job_release(&item->job);
+
+        return;
+    }
+
+    /* already sent, so the result is kept and written again instead of sending the job again */
+    php_log_err("eric: cant write spool result, retrying\n");
+    eric_server_answer_free(item->job.answer, 1);
+    pending = &ctx->pending[ctx->pendingCount++];
+    memcpy(pending->id, ctx->ids[i], ERIC_SPOOL_ID_LENGTH);
+    pending->offset = ctx->offsets[i];
+    memcpy(&pending->job, &item->job, sizeof(eric_job));
+    pending->job.dataType = pending->job.xml = pending->job.certPath = pending->job.pin = NULL;
+    item->job.returnXml = item->job.serverResponse = NULL;
+}
+
+static void eric_spool_retry_results(eric_spool_ctx *ctx)
+{
+    uint32_t i, kept = 0;
 
-        pEricRueckgabepufferFreigeben(buf);
+    for(i = 0; i < ctx->pendingCount; i++) {
+        eric_spool_pending *pending = &ctx->pending[i];
 
-        RETURN_STRING(rbuf);
+        if(eric_spool_write_result(ctx->dir, pending->id, &pending->job) == SUCCESS) {
+            eric_spool_job_release(&pending->job);
+        } else {
+            memmove(&ctx->pending[kept++], pending, sizeof(eric_spool_pending));
+        }
     }
+    ctx->pendingCount = kept;
+}
+
+/* reads the next records into batch, returns the journal offset after them */
+static off_t eric_spool_load(
+    const char *dir,
+    int fd,
+    off_t offset,
+    off_t size,
+    HashTable *pins,
+    eric_transfer_batch *batch,
+    eric_spool_ctx *ctx
+) {
+    eric_spool_header header;
+    eric_spool_trailer trailer;
+    char path[MAXPATHLEN];
+    size_t bytes = 0, len;
+    off_t recordLength;
+    char *data;
+    zval *pin;
+
+    while(batch->count < ERIC_SPOOL_READ_MAX && bytes < ERIC_SPOOL_READ_BYTES && offset < size) {
+        if(pread(fd, &header, sizeof(header), offset) != sizeof(header)) {
+            break; /* a writer is still appending, or a torn tail, see eric_spool_run() */
+        }
+        if(memcmp(header.magic, ERIC_SPOOL_MAGIC, 4) != 0 || !eric_spool_valid_id(header.id, ERIC_SPOOL_ID_LENGTH)) {
+            php_log_err("eric: corrupt spool record skipped\n");
+            offset = eric_spool_resync(fd, offset, size);
+            continue;
+        }
+        len = (size_t) header.dataTypeLength + header.xmlLength + header.certLength;
+        recordLength = (off_t) (sizeof(header) + len + sizeof(trailer));
+        if(offset + recordLength > size) {
+            break;
+        }
+
+        /* the trailer is the last thing written, lengths of a torn header would swallow the next record */
+        data = emalloc(len + sizeof(trailer));
+        if(pread(fd, data, len + sizeof(trailer), offset + sizeof(header)) != (ssize_t) (len + sizeof(trailer))) {
+            efree(data);
+            break;
+        }
+        memcpy(&trailer, data + len, sizeof(trailer));
+        if(trailer.length != sizeof(header) + len
+            || trailer.crc != (eric_spool_crc32(eric_spool_crc32(0xFFFFFFFF, (const char *) &header, sizeof(header)), data, len) ^ 0xFFFFFFFF)
+        ) {
+            efree(data);
+            php_log_err("eric: corrupt spool record skipped\n");
+            offset = eric_spool_resync(fd, offset, size);
+            continue;
+        }
+
+        /* results are written before the offset advances, so a restart skips delivered jobs;
+           a crash between sending and writing the result sends again, delivery is at least once */
+        eric_spool_result_path(path, sizeof(path), dir, header.id);
+        if(access(path, F_OK) == 0) {
+            efree(data);
+            offset += recordLength;
+            continue;
+        }
+
+        /* dataType\0xml\0cert\0 */
+        memmove(data + header.dataTypeLength + header.xmlLength + 2, data + header.dataTypeLength + header.xmlLength, header.certLength);
+        memmove(data + header.dataTypeLength + 1, data + header.dataTypeLength, header.xmlLength);
+        data[header.dataTypeLength] = '\0';
+        data[header.dataTypeLength + header.xmlLength + 1] = '\0';
+        data[len + 2] = '\0';
+
+        eric_batch_item *item = &batch->items[batch->count];
+        memset(item, 0, sizeof(eric_batch_item));
+        item->job.persistent = 1;
+        item->job.flags = header.flags;
+        item->job.dataType = data;
+        item->job.xml = data + header.dataTypeLength + 1;
+        if(header.certLength > 0) {
+            item->job.certPath = data + header.dataTypeLength + header.xmlLength + 2;
+            pin = pins != NULL ? zend_hash_str_find(pins, item->job.certPath, header.certLength) : NULL;
+            if(pin != NULL && Z_TYPE_P(pin) == IS_STRING) {
+                item->job.pin = Z_STRVAL_P(pin);
+            }
+        }
+        memcpy(ctx->ids[batch->count], header.id, ERIC_SPOOL_ID_LENGTH);
+        ctx->offsets[batch->count] = offset;
+        batch->count++;
 
-    if(ret == ERIC_GLOBAL_UTI_COUNTRY_NOT_SUPPORTED) {
-        php_log_err("eric country code not supported eric_get_tax_offices_for_country_number error\n");
+        offset += recordLength;
+        bytes += len;
     }
 
-    RETURN_FALSE;
+    return offset;
 }
-ZEND_BEGIN_ARG_INFO(arginfo_eric_get_tax_offices_for_country_number, 1)
-    ZEND_ARG_INFO(0, country_number)
-ZEND_END_ARG_INFO();
 
-PHP_FUNCTION(eric_format_tax_number)
+/* durably appends a job to eric.spool_dir, returns its id for eric_spool_result() */
+PHP_FUNCTION(eric_enqueue)
 {
-    char *orig;
-    int origLen;
+    char *dataType;
+    size_t dataTypeLength;
+    char *xml;
+    size_t xmlLength;
+    zend_long flags = ERIC_SENDE;
+    char *certPath = NULL;
+    size_t certLength = 0;
+    const char *dir;
+    eric_spool_header header;
+    eric_spool_trailer trailer;
+    struct timespec ts;
+    char *record;
+    size_t len;
 
-    ZEND_PARSE_PARAMETERS_START(1,1)
-        Z_PARAM_STRING(orig, origLen);
+    ZEND_PARSE_PARAMETERS_START(2,4)
+        Z_PARAM_STRING(dataType, dataTypeLength)
+        Z_PARAM_STRING(xml, xmlLength)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(flags)
+        Z_PARAM_STRING_OR_NULL(certPath, certLength)
     ZEND_PARSE_PARAMETERS_END();
 
-    EricRueckgabepufferHandle hout = pEricRueckgabepufferErzeugen();
-    int format = pEricFormatStNr(
-        orig,
-        hout
-    );
-    if(format != ERIC_OK) {
-        if(format == ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG) {
-            php_log_err("steuernummer ungültig\n");
-        }
+    dir = eric_spool_dir();
+    if(dir == NULL || (uint64_t) dataTypeLength + xmlLength + certLength > UINT32_MAX - sizeof(eric_spool_header)) {
+        ERIC_G(errCode) = ERIC_GLOBAL_UNGUELTIGER_PARAMETER;
+        RETURN_FALSE;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ERIC_SPOOL_MAGIC, 4);
+    header.flags = (uint32_t) flags;
+    header.dataTypeLength = dataTypeLength;
+    header.xmlLength = xmlLength;
+    header.certLength = certLength;
 
-        pEricRueckgabepufferFreigeben(hout);
+    clock_gettime(CLOCK_REALTIME, &ts);
+    char id[ERIC_SPOOL_ID_LENGTH + 1];
+    snprintf(
+        id,
+        sizeof(id),
+        "%016llx%08x%08x",
+        (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec,
+        (unsigned int) getpid(),
+        __atomic_add_fetch(&eric_spool_counter, 1, __ATOMIC_RELAXED)
+    );
+    memcpy(header.id, id, ERIC_SPOOL_ID_LENGTH);
 
-        RETURN_BOOL(IS_FALSE);
+    len = sizeof(header) + dataTypeLength + xmlLength + certLength;
+    record = emalloc(len + sizeof(eric_spool_trailer));
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), dataType, dataTypeLength);
+    memcpy(record + sizeof(header) + dataTypeLength, xml, xmlLength);
+    if(certLength > 0) {
+        memcpy(record + sizeof(header) + dataTypeLength + xmlLength, certPath, certLength);
     }
+    trailer.length = (uint32_t) len;
+    trailer.crc = eric_spool_crc32(0xFFFFFFFF, record, len) ^ 0xFFFFFFFF;
+    memcpy(record + len, &trailer, sizeof(trailer));
+    len += sizeof(trailer);
 
-    int outLen = pEricRueckgabepufferLaenge(hout) +1;
-    const char buf[outLen];
-    const char* _b = pEricRueckgabepufferInhalt(hout);
-    memcpy(
-        &buf[0],
-        &_b[0],
-        outLen
-    );
-    pEricRueckgabepufferFreigeben(hout);
+    if(eric_spool_append(dir, record, len) != SUCCESS) {
+        efree(record);
+        php_log_err("eric: cant append to spool journal\n");
+        ERIC_G(errCode) = ERIC_IO_FEHLER;
+        RETURN_FALSE;
+    }
+    efree(record);
 
-    RETURN_STRING(buf);
+    RETURN_STRINGL(id, ERIC_SPOOL_ID_LENGTH);
 }
-ZEND_BEGIN_ARG_INFO(arginfo_eric_format_tax_number, 1)
-    ZEND_ARG_INFO(0, tax_number)
-ZEND_END_ARG_INFO();
+ZEND_BEGIN_ARG_INFO(arginfo_eric_enqueue, 0)
+    ZEND_ARG_INFO(0, dataType)
+    ZEND_ARG_INFO(0, xml)
+    ZEND_ARG_INFO(0, flags)
+    ZEND_ARG_INFO(0, eric_certificate_file_path)
+ZEND_END_ARG_INFO()
 
-PHP_FUNCTION(eric_format_tax_number_to_elster)
+/* drains the spool, pins are given per certificate path and never stored; returns the number of jobs run,
+   false if a result of a sent job could not be written before stopping */
+PHP_FUNCTION(eric_spool_run)
 {
-    char *orig;
-    int origLen;
-    char *countryCode;
-    int ccLen;
-    char *taxOfficeId;
-    int toiLen;
+    zend_long concurrency = 4;
+    HashTable *pins = NULL;
+    double idleTimeout = 0;
+    const char *dir;
+    char path[MAXPATHLEN];
+    struct stat st;
+    eric_transfer_batch batch;
+    eric_spool_ctx ctx;
+    int fd, lockFd;
+    off_t offset, next;
+    double idleSince = eric_monotonic();
+    struct timespec idle = {0, 200 * 1000 * 1000};
+    uint32_t i;
 
-    ZEND_PARSE_PARAMETERS_START(3,3)
-        Z_PARAM_STRING(orig, origLen);
-        Z_PARAM_STRING(countryCode, ccLen);
-        Z_PARAM_STRING(taxOfficeId, toiLen);
+    ZEND_PARSE_PARAMETERS_START(0,3)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(concurrency)
+        Z_PARAM_ARRAY_HT_OR_NULL(pins)
+        Z_PARAM_DOUBLE(idleTimeout)
     ZEND_PARSE_PARAMETERS_END();
 
-    EricRueckgabepufferHandle hout = pEricRueckgabepufferErzeugen();
-    int format = pEricMakeElsterStnr(
-        orig,
-        countryCode,
-        taxOfficeId,
-        hout
-    );
-    if(format != ERIC_OK) {
-        if(format == ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG) {
-            php_log_err("eric_format_tax_number_to_elster: steuernummer ungültig\n");
-        }
-        if(format == ERIC_GLOBAL_LANDESNUMMER_UNBEKANNT) {
-            php_log_err("eric_format_tax_number_to_elster: landesnummer unbekannt\n");
-        }
+    dir = eric_spool_dir();
+    if(dir == NULL || lericapi == NULL) {
+        ERIC_G(errCode) = dir == NULL ? ERIC_GLOBAL_UNGUELTIGER_PARAMETER : -1;
+        RETURN_FALSE;
+    }
 
-        pEricRueckgabepufferFreigeben(hout);
+    mkdir(dir, 0700);
+    snprintf(path, sizeof(path), "%s/results", dir);
+    mkdir(path, 0700);
 
-        RETURN_BOOL(IS_FALSE);
+    /* one runner per spool */
+    snprintf(path, sizeof(path), "%s/runner.lock", dir);
+    lockFd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0600);
+    if(lockFd < 0 || flock(lockFd, LOCK_EX | LOCK_NB) != 0) {
+        if(lockFd >= 0) {
+            close(lockFd);
+        }
+        php_log_err("eric: spool is locked by another runner\n");
+        RETURN_FALSE;
     }
 
-    int outLen = pEricRueckgabepufferLaenge(hout) +1;
-    const char buf[outLen];
-    const char* _b = pEricRueckgabepufferInhalt(hout);
-    memcpy(
-        &buf[0],
-        &_b[0],
-        outLen
-    );
-    pEricRueckgabepufferFreigeben(hout);
-
-    RETURN_STRING(buf);
-}
-ZEND_BEGIN_ARG_INFO(arginfo_eric_format_tax_number_to_elster, 1)
-    ZEND_ARG_INFO(0, tax_number)
-    ZEND_ARG_INFO(0, country_code)
-    ZEND_ARG_INFO(0, tax_office_id)
-ZEND_END_ARG_INFO();
+    snprintf(path, sizeof(path), "%s/journal", dir);
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if(fd < 0) {
+        close(lockFd);
+        RETURN_FALSE;
+    }
 
-PHP_FUNCTION(eric_transfer)
-{
-    if(lericapi != NULL) {
-        char *certPath;
-        int certLength;
-        char *pin;
-        int pinLength;
-        char *dataType; /* Est_2019 */
-        int dataTypeVersionLength;
-        char *xml;
-        int xmlLength;
-        zval *serverResponse;
+    memset(&ctx, 0, sizeof(eric_spool_ctx));
+    ctx.dir = dir;
+    ctx.ids = safe_emalloc(ERIC_SPOOL_READ_MAX, ERIC_SPOOL_ID_LENGTH, 0);
+    ctx.offsets = safe_emalloc(ERIC_SPOOL_READ_MAX, sizeof(off_t), 0);
+    ctx.items = safe_emalloc(ERIC_SPOOL_READ_MAX, sizeof(eric_batch_item), 0);
+    ctx.pending = safe_emalloc(ERIC_SPOOL_READ_MAX, sizeof(eric_spool_pending), 0);
+    offset = eric_spool_read_offset(dir);
 
-        ZEND_PARSE_PARAMETERS_START(5,5)
-            Z_PARAM_ZVAL(serverResponse)
-            Z_PARAM_STRING(dataType, dataTypeVersionLength)
-            Z_PARAM_STRING(xml, xmlLength)
-            Z_PARAM_STRING(certPath, certLength)
-            Z_PARAM_STRING(pin, pinLength)
-        ZEND_PARSE_PARAMETERS_END();
+    while(EG(exception) == NULL) {
+        if(ctx.pendingCount > 0) {
+            eric_spool_retry_results(&ctx);
+        }
+        if(fstat(fd, &st) != 0) {
+            break;
+        }
+        if(offset > st.st_size) {
+            offset = 0; /* truncated behind our back */
+        }
 
-        if(pEricGetHandleToCertificate(
-                &(eric_encryption_params.zertifikatHandle),
-                certRequiresPin,
-                certPath
-            ) != ERIC_OK
-        ) {
-            eric_globals.errCode = 303; /* eric no cert found */
+        memset(&batch, 0, sizeof(eric_transfer_batch));
+        batch.items = ctx.items;
+        next = offset;
+        /* the offset must not pass a sent job until its result is written */
+        if(ctx.pendingCount == 0) {
+            next = eric_spool_load(dir, fd, offset, st.st_size, pins, &batch, &ctx);
+        }
 
-            RETURN_BOOL(IS_FALSE);
+        if(batch.count > 0) {
+            eric_transfer_batch_execute(&batch, concurrency, eric_spool_deliver, &ctx);
+            for(i = 0; i < batch.count; i++) {
+                efree((char *) batch.items[i].job.dataType);
+            }
+            for(i = 0; i < ctx.pendingCount; i++) {
+                next = MIN(next, ctx.pending[i].offset);
+            }
+            idleSince = eric_monotonic();
+        }
+        if(next != offset) {
+            offset = next;
+            eric_spool_write_offset(dir, offset);
+            continue;
         }
 
-        if(pinLength == 0) {
-            if(certRequiresPin != 0) {
-                eric_globals.errCode = 5; /* eric decryption cert err */
+        /* stuck on a record no writer is appending to anymore: skip it, or cut it off at the tail */
+        if(ctx.pendingCount == 0 && offset < st.st_size && flock(fd, LOCK_EX | LOCK_NB) == 0) {
+            off_t loaded = st.st_size;
 
-                pEricCloseHandleToCertificate(eric_encryption_params.zertifikatHandle);
-                RETURN_BOOL(IS_FALSE);
+            if(fstat(fd, &st) == 0 && st.st_size == loaded) {
+                next = eric_spool_resync(fd, offset, st.st_size);
+                if(next < st.st_size) {
+                    php_log_err("eric: corrupt spool record skipped\n");
+                    offset = next;
+                    eric_spool_write_offset(dir, offset);
+                } else if(ftruncate(fd, offset) == 0) {
+                    php_log_err("eric: torn spool record removed\n");
+                }
             }
-            pin = "";
+            flock(fd, LOCK_UN);
         }
-        eric_encryption_params.pin = pin;
 
-        EricRueckgabepufferHandle dataHandle = pEricRueckgabepufferErzeugen();
-        EricRueckgabepufferHandle serverResponseHandle = pEricRueckgabepufferErzeugen();
+        /* drained: compact once no writer can be mid-record */
+        if(offset > 0 && flock(fd, LOCK_EX | LOCK_NB) == 0) {
+            if(fstat(fd, &st) == 0 && st.st_size == offset && ftruncate(fd, 0) == 0) {
+                offset = 0;
+                eric_spool_write_offset(dir, offset);
+            }
+            flock(fd, LOCK_UN);
+        }
 
-        int err = pEricBearbeiteVorgang(
-            xml,
-            dataType,
-            ERIC_SENDE, /* ERIC_SENDE */
-            &eric_print_params,
-            &eric_encryption_params,
-            NULL,
-            dataHandle,
-            serverResponseHandle
-        );
-        pEricCloseHandleToCertificate(eric_encryption_params.zertifikatHandle);
+        if(idleTimeout >= 0 && eric_monotonic() - idleSince >= idleTimeout) {
+            break;
+        }
+        nanosleep(&idle, NULL);
+    }
 
-        int bufLength = pEricRueckgabepufferLaenge(dataHandle) +1;
-        const char buf[bufLength];
+    for(i = 0; i < ctx.pendingCount; i++) {
+        eric_spool_job_release(&ctx.pending[i].job);
+    }
+    efree(ctx.ids);
+    efree(ctx.offsets);
+    efree(ctx.items);
+    efree(ctx.pending);
+    close(fd);
+    close(lockFd);
 
-        const char* _buf = pEricRueckgabepufferInhalt(dataHandle);
-        memcpy(
-            &buf[0],
-            &_buf[0],
-            bufLength
-        );
+    if(ctx.pendingCount > 0) {
+        php_log_err("eric: spool results lost, their jobs are sent again by the next run\n");
+        ERIC_G(errCode) = ERIC_IO_FEHLER;
+        RETURN_FALSE;
+    }
 
-        pEricRueckgabepufferFreigeben(dataHandle);
+    RETURN_LONG(ctx.delivered);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_spool_run, 0)
+    ZEND_ARG_INFO(0, concurrency)
+    ZEND_ARG_INFO(0, pins)
+    ZEND_ARG_INFO(0, idle_timeout)
+ZEND_END_ARG_INFO()
 
-        int serverResponseLen = pEricRueckgabepufferLaenge(serverResponseHandle);
-        const char res[serverResponseLen];
+/* result array like eric_transfer_batch, null while the job is still spooled */
+PHP_FUNCTION(eric_spool_result)
+{
+    char *id;
+    size_t idLength;
+    const char *dir;
+    char path[MAXPATHLEN];
+    eric_spool_result_header header;
+    zend_string *returnXml, *serverResponse;
+    eric_instance *inst;
+    int fd;
 
-        const char* _resBuf = pEricRueckgabepufferInhalt(serverResponseHandle);
-        memcpy(
-            &res[0],
-            &_resBuf[0],
-            serverResponseLen
-        );
+    ZEND_PARSE_PARAMETERS_START(1,1)
+        Z_PARAM_STRING(id, idLength)
+    ZEND_PARSE_PARAMETERS_END();
 
-        ZVAL_STRING(
-            serverResponse,
-            res
-        );
+    dir = eric_spool_dir();
+    if(dir == NULL || !eric_spool_valid_id(id, idLength)) {
+        ERIC_G(errCode) = ERIC_GLOBAL_UNGUELTIGER_PARAMETER;
+        RETURN_FALSE;
+    }
 
-        pEricRueckgabepufferFreigeben(serverResponseHandle);
-        
-        eric_globals.errCode = err;
+    eric_spool_result_path(path, sizeof(path), dir, id);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        RETURN_NULL();
+    }
+    if(read(fd, &header, sizeof(header)) != sizeof(header)) {
+        close(fd);
+        RETURN_FALSE;
+    }
+    returnXml = zend_string_alloc(header.returnXmlLength, 0);
+    serverResponse = zend_string_alloc(header.serverResponseLength, 0);
+    if(read(fd, ZSTR_VAL(returnXml), header.returnXmlLength) != (ssize_t) header.returnXmlLength
+        || read(fd, ZSTR_VAL(serverResponse), header.serverResponseLength) != (ssize_t) header.serverResponseLength
+    ) {
+        zend_string_efree(returnXml);
+        zend_string_efree(serverResponse);
+        close(fd);
+        RETURN_FALSE;
+    }
+    close(fd);
+    ZSTR_VAL(returnXml)[header.returnXmlLength] = '\0';
+    ZSTR_VAL(serverResponse)[header.serverResponseLength] = '\0';
 
-        if(err == ERIC_OK) {    
-            RETURN_STRING(buf);   
+    /* texts are not spooled, eric_error_text() caches them for every later result with the same code */
+    zend_string *errorText = NULL;
+    if(header.code != ERIC_OK) {
+        errorText = eric_error_text_find(header.code);
+        if(errorText == NULL && (inst = eric_request_instance()) != NULL) {
+            errorText = eric_error_text(inst, header.code);
         }
-    } else {
-        eric_globals.errCode = -1;
     }
 
-    RETURN_FALSE;
+    array_init_size(return_value, 7);
+    add_assoc_long(return_value, "code", header.code);
+    add_assoc_str(return_value, "return_xml", returnXml);
+    add_assoc_str(return_value, "server_response", serverResponse);
+    eric_result_add_state(return_value, header.code, errorText, header.attempts, &header.timings);
 }
-ZEND_BEGIN_ARG_INFO(arginfo_eric_transfer, 1)
-    ZEND_ARG_INFO(1, server_response)
-    ZEND_ARG_INFO(0, dataType)
-    ZEND_ARG_INFO(0, xml)
-    ZEND_ARG_INFO(0, eric_certificate_file_path)
-    ZEND_ARG_INFO(0, eric_certificate_pin)
+ZEND_BEGIN_ARG_INFO(arginfo_eric_spool_result, 0)
+    ZEND_ARG_INFO(0, id)
 ZEND_END_ARG_INFO()
 
+/* flushes the request instance now, every other pooled instance at its next checkout; returns the handles closed now */
+PHP_FUNCTION(eric_cert_cache_flush)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    eric_instance *inst = eric_request_instance();
+    if(inst == NULL) {
+        RETURN_FALSE;
+    }
+
+    pthread_mutex_lock(&eric_pool_mutex);
+    inst->certGeneration = ++eric_cert_generation;
+    pthread_mutex_unlock(&eric_pool_mutex);
+
+    RETURN_LONG(eric_cert_cache_flush_all(inst));
+}
+
 PHP_FUNCTION(eric_get_error_code)
 {
-    RETURN_LONG(eric_globals.errCode);
+    RETURN_LONG(ERIC_G(errCode));
 }
 
 PHP_FUNCTION(eric_get_error)
 {
-    if(eric_globals.errCode == -1) {
-        return "ericapilib not loaded";
+    if(ERIC_G(errCode) == -1) {
+        RETURN_STRING("ericapilib not loaded");
     }
 
-    if(eric_globals.errCode != 0)  {
-        EricRueckgabepufferHandle buf = pEricRueckgabepufferErzeugen();
-        pEricHoleFehlerText(eric_globals.errCode, buf);
-
-        eric_globals.errCode = 0;
+    if(ERIC_G(errCode) != 0)  {
+        zend_string *text = eric_error_text_find(ERIC_G(errCode));
 
-        const char* ericbuf = pEricRueckgabepufferInhalt(buf);
-        int len = pEricRueckgabepufferLaenge(buf) +1;
-        char ret[len];
-        memcpy(
-            &ret[0],
-            &ericbuf[0],
-            len
-        );
+        if(text == NULL) {
+            eric_instance *inst = eric_request_instance();
+            if(inst == NULL) {
+                RETURN_FALSE;
+            }
+            text = eric_error_text(inst, ERIC_G(errCode));
+        }
 
-        pEricRueckgabepufferFreigeben(buf);
+        ERIC_G(errCode) = 0;
 
-        RETURN_STRING(ret);
+        if(text == NULL) {
+            RETURN_EMPTY_STRING();
+        }
+        RETURN_INTERNED_STR(text);
     }
 
     RETURN_NULL();
 }
 
+/* ['code','name','category','retryable','resend'] from the generated table, false for codes eric_fehlercodes.h does not know */
+PHP_FUNCTION(eric_error_info)
+{
+    zend_long code;
+    const eric_error_info *info;
+
+    ZEND_PARSE_PARAMETERS_START(1,1)
+        Z_PARAM_LONG(code)
+    ZEND_PARSE_PARAMETERS_END();
+
+    info = eric_error_lookup((int) code);
+    if(info == NULL) {
+        RETURN_FALSE;
+    }
+
+    eric_error_info_to_array(info, return_value);
+}
+ZEND_BEGIN_ARG_INFO(arginfo_eric_error_info, 0)
+    ZEND_ARG_INFO(0, code)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(eric_last_timings)
+{
+    eric_timings_to_array(&ERIC_G(lastTimings), return_value);
+}
+
+PHP_FUNCTION(eric_set_log_handler)
+{
+    zend_long handler;
+    zend_long level = -1;
+
+    ZEND_PARSE_PARAMETERS_START(1,2)
+        Z_PARAM_LONG(handler)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(level)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if(handler < ERIC_LOG_HANDLER_FILE || handler > ERIC_LOG_HANDLER_SYSLOG || level > ERIC_LOG_ERROR) {
+        ERIC_G(errCode) = ERIC_GLOBAL_UNGUELTIGER_PARAMETER;
+        RETURN_FALSE;
+    }
+
+    /* affects the whole worker process, not just this request */
+    pthread_mutex_lock(&eric_log_mutex);
+    if(level >= 0) {
+        __atomic_store_n(&eric_log_level, (int) level, __ATOMIC_RELAXED);
+    }
+    if(handler != eric_log_handler) {
+        if(handler == ERIC_LOG_HANDLER_SYSLOG) {
+            eric_log_syslog_start();
+        } else {
+            eric_log_syslog_stop();
+        }
+        __atomic_store_n(&eric_log_handler, (int) handler, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&eric_log_generation, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&eric_log_mutex);
+
+    /* pooled instances pick the change up on their next checkout */
+    if(!eric_mt_enabled) {
+        eric_log_sync(&eric_st_instance);
+    } else if(ERIC_G(instance) != NULL) {
+        eric_log_sync(ERIC_G(instance));
+    }
+
+    RETURN_TRUE;
+}
+
+ZEND_BEGIN_ARG_INFO(arginfo_eric_set_log_handler, 0)
+    ZEND_ARG_INFO(0, handler)
+    ZEND_ARG_INFO(0, level)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(eric_log_drain)
+{
+    zend_long max = 0;
+    eric_log_slot entry;
+    zval row;
+
+    ZEND_PARSE_PARAMETERS_START(0,1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(max)
+    ZEND_PARSE_PARAMETERS_END();
+
+    array_init(return_value);
+    while((max <= 0 || zend_hash_num_elements(Z_ARRVAL_P(return_value)) < max) && eric_log_pop(&entry)) {
+        array_init_size(&row, 4);
+        add_assoc_long(&row, "level", entry.level);
+        add_assoc_string(&row, "category", entry.category);
+        add_assoc_string(&row, "message", entry.message);
+        add_assoc_double(&row, "time", entry.time);
+        add_next_index_zval(return_value, &row);
+    }
+}
+
+ZEND_BEGIN_ARG_INFO(arginfo_eric_log_drain, 0)
+    ZEND_ARG_INFO(0, max)
+ZEND_END_ARG_INFO()
+
+PHP_FUNCTION(eric_log_stats)
+{
+    size_t head = __atomic_load_n(&eric_log.head, __ATOMIC_RELAXED);
+    size_t tail = __atomic_load_n(&eric_log.tail, __ATOMIC_RELAXED);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "handler", eric_log_handler);
+    add_assoc_long(return_value, "level", eric_log_level);
+    add_assoc_long(return_value, "buffered", head > tail ? head - tail : 0);
+    add_assoc_long(return_value, "capacity", eric_log.mask + 1);
+    add_assoc_long(return_value, "dropped", __atomic_load_n(&eric_log.dropped, __ATOMIC_RELAXED));
+}
+
 static zend_function_entry eric_functions[] = {
     PHP_FE(eric_init, NULL)
     PHP_FE(eric_close, NULL)
-    PHP_FE(eric_get_tax_office_country_numbers, NULL)
+    PHP_FE(eric_get_tax_office_country_numbers, arginfo_eric_get_tax_office_country_numbers)
     PHP_FE(eric_get_tax_offices_for_country_number, arginfo_eric_get_tax_offices_for_country_number)
+    PHP_FE(eric_tax_office_cache_flush, NULL)
+    PHP_FE(eric_tax_office_cache_stats, NULL)
     PHP_FE(eric_format_tax_number, arginfo_eric_format_tax_number)
     PHP_FE(eric_format_tax_number_to_elster, arginfo_eric_format_tax_number_to_elster)
+    PHP_FE(eric_validate_ibans, arginfo_eric_validate_batch)
+    PHP_FE(eric_validate_bics, arginfo_eric_validate_batch)
+    PHP_FE(eric_validate_tax_ids, arginfo_eric_validate_batch)
+    PHP_FE(eric_validate_tax_numbers, arginfo_eric_validate_batch)
+    PHP_FE(eric_validate_tax_office_numbers, arginfo_eric_validate_batch)
+    PHP_FE(eric_check_xml, arginfo_eric_check_xml)
+    PHP_FE(eric_check_cache_flush, NULL)
+    PHP_FE(eric_check_cache_stats, NULL)
     PHP_FE(eric_transfer, arginfo_eric_transfer)
+    PHP_FE(eric_process, arginfo_eric_process)
+    PHP_FE(eric_parse_server_answer, arginfo_eric_parse_server_answer)
+    PHP_FE(eric_transfer_file, arginfo_eric_transfer_file)
+    PHP_FE(eric_transfer_to, arginfo_eric_transfer_to)
+    PHP_FE(eric_transfer_batch, arginfo_eric_transfer_batch)
+    PHP_FE(eric_transfer_async, arginfo_eric_transfer_async)
+    PHP_FE(eric_poll, arginfo_eric_poll)
+    PHP_FE(eric_await, arginfo_eric_await)
+    PHP_FE(eric_async_stream, NULL)
+    PHP_FE(eric_enqueue, arginfo_eric_enqueue)
+    PHP_FE(eric_spool_run, arginfo_eric_spool_run)
+    PHP_FE(eric_spool_result, arginfo_eric_spool_result)
     PHP_FE(eric_get_error, NULL)
     PHP_FE(eric_get_error_code, NULL)
+    PHP_FE(eric_error_info, arginfo_eric_error_info)
+    PHP_FE(eric_cert_cache_flush, NULL)
+    PHP_FE(eric_last_timings, NULL)
+    PHP_FE(eric_set_log_handler, arginfo_eric_set_log_handler)
+    PHP_FE(eric_log_drain, arginfo_eric_log_drain)
+    PHP_FE(eric_log_stats, NULL)
     PHP_FE_END
 };
 
@@ -437,13 +5497,20 @@ zend_module_entry eric_module_entry = {
     PHP_MINIT(eric),
     PHP_MSHUTDOWN(eric),
     PHP_RINIT(eric),
-    NULL,
+    PHP_RSHUTDOWN(eric),
     NULL,
 #if ZEND_MODULE_API_NO >= 20010901
     PHP_ERIC_VERSION,
 #endif
-    STANDARD_MODULE_PROPERTIES
+    PHP_MODULE_GLOBALS(eric),
+    PHP_GINIT(eric),
+    NULL,
+    NULL,
+    STANDARD_MODULE_PROPERTIES_EX
 };
 
+#if defined(COMPILE_DL_ERIC) && defined(ZTS)
+ZEND_TSRMLS_CACHE_DEFINE()
+#endif
 ZEND_GET_MODULE(eric);
 
@@ -1,8 +1,21 @@
 #include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <syslog.h>
+#include <sys/eventfd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <time.h>
 
 #include "php.h"
+#include "php_ini.h"
+#include "ext/standard/md5.h"
+#include "ext/standard/crc32.h"
 
 #include "include/ericapi.h"
+#include "include/ericmtapi.h"
 #include "include/eric_fehlercodes.h"
 #include "include/eric_types.h"
 
@@ -31,6 +44,28 @@ extern zend_module_entry eric_module_entry;
 #include "TSRM.h"
 #endif
 
+/* seconds spent per ERIC_FORTSCHRITTCALLBACK_ID_* phase (10..50) of one EricBearbeiteVorgang */
+#define ERIC_PHASE_COUNT 5
+
+typedef struct _eric_timings {
+    double phases[ERIC_PHASE_COUNT];
+    double total;
+} eric_timings;
+
+ZEND_BEGIN_MODULE_GLOBALS(eric)
+    int errCode;
+    struct _eric_instance *instance; /* checked out for the current request */
+    eric_timings lastTimings; /* of the last eric_transfer */
+    struct _eric_async_notifier *notifier; /* eventfd signalled by this request's futures */
+    zend_ulong epoch; /* eric_epoch at RINIT, retired values from before stay allocated */
+ZEND_END_MODULE_GLOBALS(eric)
+
+#define ERIC_G(v) ZEND_MODULE_GLOBALS_ACCESSOR(eric, v)
+
+#if defined(ZTS) && defined(COMPILE_DL_ERIC)
+ZEND_TSRMLS_CACHE_EXTERN()
+#endif
+
 void *lericapi = NULL;
 
 int (*pEricInitialisiere)(const char* pluginPath, const char* logPath);
@@ -178,4 +213,178 @@ int (*pEricRueckgabepufferFreigeben)(EricRueckgabepufferHandle handle);
 const char* (*pEricRueckgabepufferInhalt)(EricRueckgabepufferHandle handle);
 uint32_t (*pEricRueckgabepufferLaenge)(EricRueckgabepufferHandle handle);
 int (*pEricSystemCheck)();
-int (*pEricVersion)(EricRueckgabepufferHandle rueckgabeXmlPuffer);
\ No newline at end of file
+int (*pEricVersion)(EricRueckgabepufferHandle rueckgabeXmlPuffer);
+
+EricInstanzHandle (*pEricMtInstanzErzeugen)(
+	const char* pluginPfad,
+	const char* logPfad
+);
+int (*pEricMtInstanzFreigeben)(EricInstanzHandle instanz);
+int (*pEricMtChangePassword)(
+	EricInstanzHandle instanz,
+	const char* psePath,
+	const char* oldBin,
+	const char* newPin
+);
+int (*pEricMtPruefeBuFaNummer)(EricInstanzHandle instanz, const char* steuernummer);
+int (*pEricMtBearbeiteVorgang)(
+	EricInstanzHandle instanz,
+	const char *datenPuffer,
+	const char* datenartVersion,
+	uint32_t bearbeitungsFlag,
+	const eric_druck_parameter_t* druckParameter,
+	const eric_verschluesselungs_parameter_t* cryptoParameter,
+	EricTransferHandle* transferHandle,
+	EricRueckgabepufferHandle rueckgabeXmlPuffer,
+	EricRueckgabepufferHandle serverantwortXmlPuffer
+);
+int (*pEricMtCheckXML)(
+	EricInstanzHandle instanz,
+	const char* xml, 
+	const char* datenartVersion, 
+	EricRueckgabepufferHandle fehlertextPuffer
+);
+int (*pEricMtCloseHandleToCertificate)(EricInstanzHandle instanz, EricZertifikatHandle hToken);
+int (*pEricMtCreateKey)(
+	EricInstanzHandle instanz,
+	const char* pin, 
+	const char *pfad, 
+	eric_zertifikat_parameter_t* zertifikatInfo
+);
+int (*pEricMtCreateTH)(
+	EricInstanzHandle instanz,
+	const char* xml,
+	const char* verfahren,
+	const char* datendart,
+	const char* vorgang,
+	const char* testmerker,
+	const char* herstellerId,
+	const char* datenLieferant,
+	const char* versionClient,
+	const char* pulicKey,
+	EricRueckgabepufferHandle xmlRueckgabePuffer
+);
+int (*pEricMtDekodiereDaten)(
+	EricInstanzHandle instanz,
+	EricZertifikatHandle zertifikatHandle,
+	const char* pin,
+	const char* base64Eingabe,
+	EricRueckgabepufferHandle rueckgabePuffer
+);
+int (*pEricMtEinstellungAlleZuruecksetzen)(EricInstanzHandle instanz);
+int (*pEricMtEinstellungLesen)(
+	EricInstanzHandle instanz,
+	const char* name,
+	EricRueckgabepufferHandle rueckgabePuffer
+);
+int (*pEricMtEinstellungSetzen)(
+	EricInstanzHandle instanz,
+	const char* name,
+	const char* wert
+);
+int (*pEricMtEinstellungZuruecksetzen)(EricInstanzHandle instanz, const char* name);
+int (*pEricMtEntladePlugins)(EricInstanzHandle instanz);
+int (*pEricMtFormatStNr)(
+	EricInstanzHandle instanz,
+	const char* eingabeSteuernummer,
+	EricRueckgabepufferHandle rueckgabePuffer
+);
+int (*pEricMtGetAuswahlListen)(
+	EricInstanzHandle instanz,
+	const char* datenartVersion,
+	const char* feldkennung,
+	EricRueckgabepufferHandle rueckgabeXmlPuffer
+);
+int (*pEricMtGetErrormessagesFromXMLAnswer)(
+	EricInstanzHandle instanz,
+	const char* xml,
+	EricRueckgabepufferHandle transferticketPuffer,
+	EricRueckgabepufferHandle returncodeTHPuffer,
+	EricRueckgabepufferHandle fehlertextTHPuffer,
+	EricRueckgabepufferHandle returncodesUndFehlertexteNDHXmlPuffer
+);
+int (*pEricMtGetHandleToCertificate)(
+	EricInstanzHandle instanz,
+	EricZertifikatHandle* hToken,
+	uint32_t* iInfoPinSupport,
+	const byteChar* pathToKeystore
+);
+int (*pEricMtGetPinStatus)(
+	EricInstanzHandle instanz,
+	EricZertifikatHandle hToken,
+	uint32_t* pinStatus,
+	uint32_t keyType
+);
+int (*pEricMtGetPublicKey)(
+	EricInstanzHandle instanz,
+	const eric_verschluesselungs_parameter_t* cryptoParameter,
+	EricRueckgabepufferHandle rueckgabePuffer
+);
+int (*pEricMtHoleFehlerText)(
+	EricInstanzHandle instanz,
+	int fehlerkode,
+	EricRueckgabepufferHandle rueckgabePuffer
+);
+int (*pEricMtHoleFinanzaemter)(
+	EricInstanzHandle instanz,
+	const char* finanzamtLandNummer,
+	EricRueckgabepufferHandle rueckgabeXmlPuffer
+);
+int (*pEricMtHoleFinanzamtLandNummern)(EricInstanzHandle instanz, EricRueckgabepufferHandle ruckgabeXmlPuffer);
+int (*pEricMtHoleFinanzamtsdaten)(
+	EricInstanzHandle instanz,
+	const char bufaNr[5],
+	EricRueckgabepufferHandle rueckgabeXmlPuffer
+);
+int (*pEricMtHoleTestfinanzaemter)(EricInstanzHandle instanz, EricRueckgabepufferHandle rueckgabeXmlPuffer);
+int (*pEricMtHoleZertifikatEigenschaften)(
+	EricInstanzHandle instanz,
+	EricZertifikatHandle hToken,
+	const char* pin,
+	EricRueckgabepufferHandle rueckgabeXmlPuffer
+);
+int (*pEricMtHoleZertifikatFingerabdruck)(
+	EricInstanzHandle instanz,
+	const eric_verschluesselungs_parameter_t* cryptoParameter,
+	EricRueckgabepufferHandle fingerabdruckPuffer,
+	EricRueckgabepufferHandle signaturPuffer
+);
+int (*pEricMtMakeElsterStnr)(
+	EricInstanzHandle instanz,
+	const char* steuernrBescheid,
+    const char landesnr[2+1],
+    const char bundesfinanzamtsnr[4+1],
+    EricRueckgabepufferHandle steuernrPuffer
+);
+int (*pEricMtPruefeBIC)(EricInstanzHandle instanz, const char* bic);
+int (*pEricMtPruefeIBAN)(EricInstanzHandle instanz, const char* iban);
+int (*pEricMtPruefeIdentifikationsMerkmal)(EricInstanzHandle instanz, const char* steuerId);
+int (*pEricMtPruefeSteuernummer)(EricInstanzHandle instanz, const char* steuernummer);
+int (*pEricMtPruefeZertifikatPin)(
+	EricInstanzHandle instanz,
+	const char* pathToKeystore,
+	const char* pin,
+	uint32_t keyType
+);
+int (*pEricMtRegistriereFortschrittCallback)(
+	EricInstanzHandle instanz,
+	EricFortschrittCallback funktion,
+	void* benutzerdaten
+);
+int (*pEricMtRegistriereGlobalenFortschrittCallback)(
+	EricInstanzHandle instanz,
+	EricFortschrittCallback funktion,
+	void* benutzerdaten
+);
+int (*pEricMtRegistriereLogCallback)(
+	EricInstanzHandle instanz,
+	EricLogCallback funktion,
+	uint32_t schreibeEricLogDatei,
+	void* benutzerdaten
+);
+EricRueckgabepufferHandle (*pEricMtRueckgabepufferErzeugen)(EricInstanzHandle instanz);
+int (*pEricMtRueckgabepufferFreigeben)(EricInstanzHandle instanz, EricRueckgabepufferHandle handle);
+const char* (*pEricMtRueckgabepufferInhalt)(EricInstanzHandle instanz, EricRueckgabepufferHandle handle);
+uint32_t (*pEricMtRueckgabepufferLaenge)(EricInstanzHandle instanz, EricRueckgabepufferHandle handle);
+int (*pEricMtSystemCheck)(EricInstanzHandle instanz);
+int (*pEricMtVersion)(EricInstanzHandle instanz, EricRueckgabepufferHandle rueckgabeXmlPuffer);
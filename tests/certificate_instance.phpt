@@ -0,0 +1,37 @@
+--TEST--
+EricCertificate shares the request instance, a pool of one does not block eric_transfer()
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+eric.multithreading=1
+eric.instance_pool_size=1
+--FILE--
+<?php
+$path = __DIR__ . '/certificate_instance.tmp.pfx';
+file_put_contents($path, 'stub');
+
+$cert = new EricCertificate($path);
+var_dump(is_string(eric_transfer($response, 'UStVA_2024', '<Elster><StubId>p</StubId></Elster>', $path, '123456')));
+var_dump(is_string($cert->process($response, 'UStVA_2024', '<Elster><StubId>c</StubId></Elster>', ERIC_SENDE, '123456')));
+var_dump(strpos($response, 'T-c') !== false);
+
+try {
+    new EricCertificate(__DIR__ . '/missing.pfx');
+} catch(Exception $e) {
+    echo get_class($e), ': ', $e->getMessage(), "\n";
+}
+var_dump(eric_validate_tax_ids(['86095742719'])[0]);
+
+$cert->close();
+var_dump(eric_validate_tax_ids(['86095742719'])[0]);
+?>
+--CLEAN--
+<?php @unlink(__DIR__ . '/certificate_instance.tmp.pfx'); ?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+Exception: certificate could not be opened
+int(0)
+int(0)
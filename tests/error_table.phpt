@@ -0,0 +1,79 @@
+--TEST--
+eric_error_table.awk classifies eric_fehlercodes.h entries, the extension uses its output
+--SKIPIF--
+<?php
+if(!extension_loaded('eric')) die('skip eric not loaded');
+if(trim((string) shell_exec('command -v awk')) === '') die('skip awk not available');
+?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+--FILE--
+<?php
+$src = dirname(__DIR__);
+$awk = 'awk -f ' . escapeshellarg("$src/eric_error_table.awk") . ' ';
+
+$header = <<<'H'
+enum {
+    ERIC_OK = 0,
+    ERIC_GLOBAL_PRUEF_FEHLER = 610001002,
+    ERIC_TRANSFER_ERR_TIMEOUT = 610101283,
+    ERIC_TRANSFER_ERR_CONNECTSERVER = 610101278,
+    ERIC_TRANSFER_ERR_XML_THEADER = 610101210,
+    ERIC_TRANSFER_EID_SERVERFEHLER = 610101512,
+    ERIC_CRYPT_E_BUSY = 610201103,
+    ERIC_IO_MASTERDATENSERVICE_NICHT_VERFUEGBAR = 610301010,
+    ERIC_PRINT_INTERNER_FEHLER = 610501001,
+    /* ERIC_GLOBAL_COMMENTED = 1 */
+    ERIC_NOT_A_CODE
+};
+
+H;
+file_put_contents(__DIR__ . '/error_table.tmp.h', $header);
+echo shell_exec($awk . escapeshellarg(__DIR__ . '/error_table.tmp.h'));
+
+/* the checked in header is the generator output for the shipped eric_fehlercodes.h */
+var_dump(shell_exec($awk . escapeshellarg("$src/include/eric_fehlercodes.h")) === file_get_contents("$src/eric_error_table.h"));
+
+var_dump(EricError::TRANSFER_ERR_TIMEOUT, EricError::OK, EricError::CATEGORY_SERVER);
+var_dump(eric_error_info(EricError::TRANSFER_ERR_TIMEOUT));
+var_dump(eric_error_info(610101512)['category'], eric_error_info(610001002)['retryable']);
+var_dump(eric_error_info(EricError::TRANSFER_ERR_CONNECTSERVER)['category'], eric_error_info(EricError::TRANSFER_ERR_CONNECTSERVER)['retryable']);
+var_dump(eric_error_info(42));
+?>
+--CLEAN--
+<?php
+@unlink(__DIR__ . '/error_table.tmp.h');
+?>
+--EXPECT--
+/* generated from include/eric_fehlercodes.h by eric_error_table.awk, do not edit */
+/* ERIC_ERROR_ENTRY(code, category, retry) */
+ERIC_ERROR_ENTRY(ERIC_OK, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_GLOBAL_PRUEF_FEHLER, ERIC_ERROR_CATEGORY_GLOBAL, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_TIMEOUT, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_RESEND)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_CONNECTSERVER, ERIC_ERROR_CATEGORY_TRANSFER, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_ERR_XML_THEADER, ERIC_ERROR_CATEGORY_SERVER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_TRANSFER_EID_SERVERFEHLER, ERIC_ERROR_CATEGORY_SERVER, ERIC_ERROR_RETRY_NEVER)
+ERIC_ERROR_ENTRY(ERIC_CRYPT_E_BUSY, ERIC_ERROR_CATEGORY_CRYPT, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_IO_MASTERDATENSERVICE_NICHT_VERFUEGBAR, ERIC_ERROR_CATEGORY_IO, ERIC_ERROR_RETRY_SAFE)
+ERIC_ERROR_ENTRY(ERIC_PRINT_INTERNER_FEHLER, ERIC_ERROR_CATEGORY_PRINT, ERIC_ERROR_RETRY_NEVER)
+bool(true)
+int(610101283)
+int(0)
+string(6) "server"
+array(5) {
+  ["code"]=>
+  int(610101283)
+  ["name"]=>
+  string(25) "ERIC_TRANSFER_ERR_TIMEOUT"
+  ["category"]=>
+  string(8) "transfer"
+  ["retryable"]=>
+  bool(false)
+  ["resend"]=>
+  bool(true)
+}
+string(6) "server"
+bool(false)
+string(8) "transfer"
+bool(true)
+bool(false)
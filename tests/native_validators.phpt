@@ -0,0 +1,57 @@
+--TEST--
+eric.native_validators checks IBAN, BIC and IdNr without calling libericapi
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+eric.native_validators=1
+--FILE--
+<?php
+var_dump(eric_validate_ibans([
+    'DE89370400440532013000',
+    'DE89370400440532013001',   /* check digits */
+    'DE8937040044053201300',    /* length */
+    'RE4220041010050500013M02606', /* french territory, not in the iban registry */
+    'de89370400440532013000',
+    "DE89370400440532013000\0trailing",
+]));
+var_dump(eric_validate_bics(['DEUTDEFF', 'DEUTDEFF500', 'DEUTXXFF', 'DEUT1EFF', "DEUTDEFF\0"]));
+var_dump(eric_validate_tax_ids(['86095742719', '86095742718', '06095742719', '1234567890a']));
+?>
+--EXPECT--
+array(6) {
+  [0]=>
+  int(0)
+  [1]=>
+  int(610001504)
+  [2]=>
+  int(610001503)
+  [3]=>
+  int(610001502)
+  [4]=>
+  int(610001501)
+  [5]=>
+  int(0)
+}
+array(5) {
+  [0]=>
+  int(0)
+  [1]=>
+  int(0)
+  [2]=>
+  int(610001511)
+  [3]=>
+  int(610001510)
+  [4]=>
+  int(0)
+}
+array(4) {
+  [0]=>
+  int(0)
+  [1]=>
+  int(610001525)
+  [2]=>
+  int(610001525)
+  [3]=>
+  int(610001525)
+}
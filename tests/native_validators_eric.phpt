@@ -0,0 +1,26 @@
+--TEST--
+eric.native_validators agrees with libericapi (set ERIC_TEST_LIBRARY to a real libericapi.so)
+--SKIPIF--
+<?php
+if(!extension_loaded('eric')) die('skip eric not loaded');
+if(!getenv('ERIC_TEST_LIBRARY')) die('skip ERIC_TEST_LIBRARY not set');
+?>
+--FILE--
+<?php
+/* eric.library_path is a system setting, so the comparison runs in a child with the real library */
+$cmd = [
+    getenv('TEST_PHP_EXECUTABLE'),
+    '-n',
+    '-d', 'extension_dir=' . ini_get('extension_dir'),
+    '-d', 'extension=eric',
+    '-d', 'eric.library_path=' . getenv('ERIC_TEST_LIBRARY'),
+    '-d', 'eric.plugin_path=' . (getenv('ERIC_TEST_PLUGIN_PATH') ?: dirname(getenv('ERIC_TEST_LIBRARY')) . '/plugins2'),
+    '-d', 'eric.log_path=' . sys_get_temp_dir(),
+    __DIR__ . '/native_validators.inc',
+];
+$proc = proc_open($cmd, [1 => ['pipe', 'w'], 2 => ['pipe', 'w']], $pipes);
+echo stream_get_contents($pipes[1]), stream_get_contents($pipes[2]);
+proc_close($proc);
+?>
+--EXPECT--
+0 mismatches
@@ -0,0 +1,38 @@
+--TEST--
+EricRetrieval shares the request instance, a pool of one does not block procedural calls
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+eric.multithreading=1
+eric.instance_pool_size=1
+--FILE--
+<?php
+$cert = __DIR__ . '/retrieval_instance.tmp.pfx';
+file_put_contents($cert, 'stub');
+
+$first = new EricRetrieval($cert, '123456');
+$second = new EricRetrieval($cert, '123456');
+var_dump(is_string(eric_transfer($response, 'UStVA_2024', '<Elster><StubId>p</StubId></Elster>', $cert, '123456')));
+var_dump(strpos($response, 'T-p') !== false);
+
+var_dump(is_string($first->send($response, 'Datenabholung_2024', '<Elster><StubId>r</StubId></Elster>')));
+var_dump(strpos($response, 'T-r') !== false);
+
+/* the instance stays with the sessions, so the future runs right away instead of waiting for a worker */
+$future = eric_transfer_async('UStVA_2024', '<Elster/>', ERIC_VALIDIERE);
+var_dump(eric_await($future, 5)['code']);
+
+$first->close();
+var_dump(eric_validate_tax_ids(['86095742719'])[0]);
+/* $second is freed after RSHUTDOWN and gives the instance back then */
+?>
+--CLEAN--
+<?php @unlink(__DIR__ . '/retrieval_instance.tmp.pfx'); ?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+int(0)
+int(0)
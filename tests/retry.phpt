@@ -0,0 +1,32 @@
+--TEST--
+failures before sending are retried, failures that may follow delivery are not sent again by default
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+eric.retry_attempts=3
+eric.retry_backoff=0
+--FILE--
+<?php
+$cert = __DIR__ . '/retry.tmp.pfx';
+file_put_contents($cert, 'stub');
+putenv('ERIC_STUB_SEND_LOG=' . __DIR__ . '/retry.tmp.sends');
+
+var_dump(is_string(eric_process($response, 'UStVA_2024', '<Elster><StubId>c</StubId><StubFail>1</StubFail></Elster>', ERIC_SENDE, $cert, '123456')));
+var_dump(eric_process($response, 'UStVA_2024', '<Elster><StubId>t</StubId><StubFail>1</StubFail><StubFailCode>610101283</StubFailCode></Elster>', ERIC_SENDE, $cert, '123456'));
+var_dump(eric_get_error_code() === EricError::TRANSFER_ERR_TIMEOUT);
+
+echo file_get_contents(__DIR__ . '/retry.tmp.sends');
+?>
+--CLEAN--
+<?php
+@unlink(__DIR__ . '/retry.tmp.pfx');
+@unlink(__DIR__ . '/retry.tmp.sends');
+?>
+--EXPECT--
+bool(true)
+bool(false)
+bool(true)
+c
+c
+t
@@ -0,0 +1,75 @@
+--TEST--
+server_answer parses the transfer and nutzdaten headers of the server response
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+--FILE--
+<?php
+$cert = __DIR__ . '/server_answer.tmp.pfx';
+$xmlPath = __DIR__ . '/server_answer.tmp.xml';
+file_put_contents($cert, 'stub');
+file_put_contents($xmlPath, '<Elster><StubId>f</StubId></Elster>');
+
+var_dump(is_string(eric_transfer($response, 'UStVA_2024', '<Elster><StubId>a</StubId></Elster>', $cert, '123456', $answer)));
+var_dump($answer);
+
+/* a kept server_response gives the same answer later */
+var_dump(eric_parse_server_answer($response) === $answer);
+
+var_dump(is_string(eric_transfer_file($response, 'UStVA_2024', $xmlPath, ERIC_SENDE, $cert, '123456', null, $fileAnswer)));
+var_dump($fileAnswer['transferticket'], $fileAnswer['ndh'] === $answer['ndh']);
+
+$certificate = new EricCertificate($cert);
+var_dump(is_string($certificate->process($response, 'UStVA_2024', '<Elster><StubId>c</StubId></Elster>', ERIC_SENDE, '123456', $certAnswer)));
+var_dump($certAnswer['transferticket'], $certAnswer['text'] === $answer['text']);
+
+/* no server response without sending */
+$validated = 'unchanged';
+eric_transfer_file($response, 'UStVA_2024', $xmlPath, ERIC_VALIDIERE, null, '', null, $validated);
+var_dump($validated);
+
+var_dump(eric_parse_server_answer('<Elster/>'), eric_get_error_code() === EricError::IO_PARSE_FEHLER);
+?>
+--CLEAN--
+<?php
+@unlink(__DIR__ . '/server_answer.tmp.pfx');
+@unlink(__DIR__ . '/server_answer.tmp.xml');
+?>
+--EXPECT--
+bool(true)
+array(4) {
+  ["transferticket"]=>
+  string(3) "T-a"
+  ["code"]=>
+  int(0)
+  ["text"]=>
+  string(49) "Daten wurden erfolgreich angenommen & verarbeitet"
+  ["ndh"]=>
+  array(2) {
+    [0]=>
+    array(2) {
+      ["code"]=>
+      int(0)
+      ["text"]=>
+      string(2) "OK"
+    }
+    [1]=>
+    array(2) {
+      ["code"]=>
+      int(10)
+      ["text"]=>
+      string(11) "Hinweis <a>"
+    }
+  }
+}
+bool(true)
+bool(true)
+string(3) "T-f"
+bool(true)
+bool(true)
+string(3) "T-c"
+bool(true)
+NULL
+bool(false)
+bool(true)
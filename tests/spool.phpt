@@ -0,0 +1,115 @@
+--TEST--
+eric_enqueue() appends to the journal, eric_spool_run() delivers, stores results and compacts
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+eric.spool_dir={PWD}/spool.tmp
+eric.retry_attempts=3
+eric.retry_backoff=0
+error_log={PWD}/spool.tmp.log
+--FILE--
+<?php
+$dir = __DIR__ . '/spool.tmp';
+$cert = "$dir.pfx";
+file_put_contents($cert, 'stub');
+putenv("ERIC_STUB_SEND_LOG=$dir.sends");
+
+$ids = [
+    eric_enqueue('UStVA_2024', '<Elster><StubId>a</StubId></Elster>', ERIC_SENDE, $cert),
+    eric_enqueue('UStVA_2024', '<Elster><StubId>b</StubId><StubFail>1</StubFail></Elster>', ERIC_SENDE, $cert),
+    eric_enqueue('UStVA_2024', '<Elster><StubCode>610001002</StubCode></Elster>', ERIC_VALIDIERE),
+];
+var_dump(strlen($ids[0]), count(array_unique($ids)));
+var_dump(eric_spool_result($ids[0]));
+var_dump(filesize("$dir/journal") > 0);
+
+echo "run\n";
+var_dump(eric_spool_run(2, null, 0));
+clearstatcache();
+var_dump(filesize("$dir/journal"));
+
+$a = eric_spool_result($ids[0]);
+var_dump($a['code'], $a['attempts'], strpos($a['server_response'], 'T-a') !== false);
+$b = eric_spool_result($ids[1]);
+var_dump($b['code'], $b['attempts']);
+$c = eric_spool_result($ids[2]);
+var_dump($c['code'], $c['error'], $c['error_info']['name']);
+
+echo "restart\n";
+$e = eric_enqueue('UStVA_2024', '<Elster><StubId>e</StubId></Elster>', ERIC_SENDE, $cert);
+$journal = file_get_contents("$dir/journal");
+var_dump(eric_spool_run(1, null, 0));
+/* a runner that died before advancing the offset replays the journal, finished jobs have a result */
+file_put_contents("$dir/journal", $journal);
+file_put_contents("$dir/journal.offset", "0\n");
+var_dump(eric_spool_run(1, null, 0));
+var_dump(eric_spool_result($e)['code']);
+
+echo "torn\n";
+$t = eric_enqueue('UStVA_2024', '<Elster><StubId>t</StubId></Elster>', ERIC_SENDE, $cert);
+$record = file_get_contents("$dir/journal");
+/* a crash in the middle of an append, the next record lands right behind the partial one */
+file_put_contents("$dir/journal", substr($record, 0, 60));
+$u = eric_enqueue('UStVA_2024', '<Elster><StubId>u</StubId></Elster>', ERIC_SENDE, $cert);
+var_dump(eric_spool_run(1, null, 0));
+var_dump(eric_spool_result($t), eric_spool_result($u)['code']);
+/* a partial record at the tail is removed instead of blocking the runner */
+file_put_contents("$dir/journal", substr($record, 0, 60));
+file_put_contents("$dir/journal.offset", "0\n");
+var_dump(eric_spool_run(1, null, 0));
+clearstatcache();
+var_dump(filesize("$dir/journal"));
+
+$sends = file("$dir.sends");
+sort($sends);
+echo implode('', $sends);
+var_dump(eric_spool_result('not-an-id'));
+?>
+--CLEAN--
+<?php
+$dir = __DIR__ . '/spool.tmp';
+foreach(glob("$dir/results/*") as $file) {
+    unlink($file);
+}
+@rmdir("$dir/results");
+foreach(glob("$dir/*") as $file) {
+    unlink($file);
+}
+@rmdir($dir);
+@unlink("$dir.pfx");
+@unlink("$dir.sends");
+@unlink("$dir.log");
+?>
+--EXPECT--
+int(32)
+int(3)
+NULL
+bool(true)
+run
+int(3)
+int(0)
+int(0)
+int(1)
+bool(true)
+int(0)
+int(2)
+int(610001002)
+string(20) "stub error 610001002"
+string(24) "ERIC_GLOBAL_PRUEF_FEHLER"
+restart
+int(1)
+int(0)
+int(0)
+torn
+int(1)
+NULL
+int(0)
+int(0)
+int(0)
+a
+b
+b
+e
+u
+bool(false)
@@ -0,0 +1,617 @@
+/*
+ * minimal libericapi stand-in for the phpt tests and benchmarks, not a reimplementation of ERiC
+ *
+ * behaviour is driven by the input xml and the environment:
+ *   <StubCode>n</StubCode>        EricBearbeiteVorgang/EricCheckXML return n
+ *   <StubFail>k</StubFail>        the first k sends of a <StubId> fail with ERIC_TRANSFER_ERR_CONNECTSERVER
+ *   <StubFailCode>n</StubFailCode> ... or with n instead
+ *   <StubId>id</StubId>           echoed as transferticket "T-id", appended to ERIC_STUB_SEND_LOG per send
+ *   ERIC_STUB_RETURN_SIZE         size of the return xml in bytes
+ *   ERIC_STUB_VERSION             version reported by EricVersion (default "stub-1")
+ *   ERIC_STUB_PIN_SUPPORT         iInfoPinSupport of every certificate (default 0)
+ *   ERIC_STUB_FAIL_INSTANCE       EricMtInstanzErzeugen fails when set
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "include/ericapi.h"
+#include "include/ericmtapi.h"
+#include "include/eric_fehlercodes.h"
+
+struct EricReturnBufferApi {
+    char *data;
+    size_t len;
+};
+
+struct EricInstanz {
+    EricLogCallback log;
+    void *logData;
+    EricFortschrittCallback progress;
+    void *progressData;
+};
+
+static struct EricInstanz stub_st;
+static pthread_mutex_t stub_mutex = PTHREAD_MUTEX_INITIALIZER;
+static EricZertifikatHandle stub_next_cert = 1;
+
+#define STUB_FAIL_SLOTS 64
+static struct { char id[64]; int sends; } stub_fails[STUB_FAIL_SLOTS];
+
+static void stub_set(EricRueckgabepufferHandle buf, const char *data, size_t len)
+{
+    free(buf->data);
+    buf->data = malloc(len + 1);
+    memcpy(buf->data, data, len);
+    buf->data[len] = '\0';
+    buf->len = len;
+}
+
+static void stub_sets(EricRueckgabepufferHandle buf, const char *str)
+{
+    if(buf != NULL) {
+        stub_set(buf, str, strlen(str));
+    }
+}
+
+/* eric hands out transfer header texts as plain text, not as xml */
+static void stub_set_text(EricRueckgabepufferHandle buf, const char *xml, size_t len)
+{
+    static const char *entities[][2] = {{"&amp;", "&"}, {"&lt;", "<"}, {"&gt;", ">"}};
+    char *text = malloc(len + 1);
+    size_t i = 0, n = 0, e;
+
+    while(i < len) {
+        for(e = 0; e < 3; e++) {
+            size_t entityLen = strlen(entities[e][0]);
+            if(len - i >= entityLen && memcmp(xml + i, entities[e][0], entityLen) == 0) {
+                text[n++] = entities[e][1][0];
+                i += entityLen;
+                break;
+            }
+        }
+        if(e == 3) {
+            text[n++] = xml[i++];
+        }
+    }
+    stub_set(buf, text, n);
+    free(text);
+}
+
+/* content of the first <tag> at or after from, NULL if missing */
+static const char *stub_tag(const char *from, const char *end, const char *tag, size_t *len)
+{
+    char open[64], close[64];
+    const char *start, *stop;
+
+    snprintf(open, sizeof(open), "<%s>", tag);
+    snprintf(close, sizeof(close), "</%s>", tag);
+    start = strstr(from, open);
+    if(start == NULL || (end != NULL && start >= end)) {
+        return NULL;
+    }
+    start += strlen(open);
+    stop = strstr(start, close);
+    if(stop == NULL || (end != NULL && stop > end)) {
+        return NULL;
+    }
+    *len = stop - start;
+
+    return start;
+}
+
+static int stub_tag_int(const char *xml, const char *tag, int fallback)
+{
+    size_t len;
+    const char *value = stub_tag(xml, NULL, tag, &len);
+
+    return value != NULL ? atoi(value) : fallback;
+}
+
+static int stub_should_fail(const char *id, size_t idLen, int failTimes)
+{
+    int i, fail = 0;
+
+    pthread_mutex_lock(&stub_mutex);
+    for(i = 0; i < STUB_FAIL_SLOTS; i++) {
+        if(stub_fails[i].id[0] == '\0' || (strlen(stub_fails[i].id) == idLen && memcmp(stub_fails[i].id, id, idLen) == 0)) {
+            snprintf(stub_fails[i].id, sizeof(stub_fails[i].id), "%.*s", (int) idLen, id);
+            fail = stub_fails[i].sends++ < failTimes;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&stub_mutex);
+
+    return fail;
+}
+
+static void stub_log_send(const char *id, size_t idLen)
+{
+    const char *path = getenv("ERIC_STUB_SEND_LOG");
+    FILE *f;
+
+    if(path == NULL || (f = fopen(path, "a")) == NULL) {
+        return;
+    }
+    fprintf(f, "%.*s\n", (int) idLen, id);
+    fclose(f);
+}
+
+static void stub_progress(struct EricInstanz *inst, uint32_t id)
+{
+    if(inst->progress != NULL) {
+        inst->progress(id, 0, 1, inst->progressData);
+        inst->progress(id, 1, 1, inst->progressData);
+    }
+}
+
+static int stub_bearbeite(
+    struct EricInstanz *inst,
+    const char *xml,
+    const char *datenartVersion,
+    uint32_t flags,
+    const eric_verschluesselungs_parameter_t *crypto,
+    EricRueckgabepufferHandle rueckgabe,
+    EricRueckgabepufferHandle antwort
+) {
+    const char *id, *size = getenv("ERIC_STUB_RETURN_SIZE");
+    size_t idLen = 0;
+    char response[1024];
+    int code;
+
+    if(xml == NULL || datenartVersion == NULL) {
+        return ERIC_GLOBAL_NULL_PARAMETER;
+    }
+    if((flags & ERIC_SENDE) && crypto == NULL) {
+        return ERIC_GLOBAL_VERSCHLUESSELUNGS_PARAMETER_NICHT_ANGEGEBEN;
+    }
+    if(inst->log != NULL) {
+        inst->log("eric.stub", ERIC_LOG_INFO, "EricBearbeiteVorgang", inst->logData);
+    }
+
+    stub_progress(inst, ERIC_FORTSCHRITTCALLBACK_ID_EINLESEN);
+    stub_progress(inst, ERIC_FORTSCHRITTCALLBACK_ID_VALIDIEREN);
+
+    code = stub_tag_int(xml, "StubCode", ERIC_OK);
+    if(size != NULL) {
+        size_t n = (size_t) atol(size);
+        char *data = malloc(n + 1);
+
+        memset(data, 'x', n);
+        stub_set(rueckgabe, data, n);
+        free(data);
+    } else {
+        stub_sets(rueckgabe, "<EricBearbeiteVorgang><Erfolg><Telenummer>stub</Telenummer></Erfolg></EricBearbeiteVorgang>");
+    }
+    if(code != ERIC_OK || !(flags & ERIC_SENDE)) {
+        return code;
+    }
+
+    stub_progress(inst, ERIC_FORTSCHRITTCALLBACK_ID_SENDEN);
+    id = stub_tag(xml, NULL, "StubId", &idLen);
+    if(id == NULL) {
+        id = "none";
+        idLen = 4;
+    }
+    stub_log_send(id, idLen);
+    if(stub_should_fail(id, idLen, stub_tag_int(xml, "StubFail", 0))) {
+        return stub_tag_int(xml, "StubFailCode", ERIC_TRANSFER_ERR_CONNECTSERVER);
+    }
+
+    snprintf(
+        response,
+        sizeof(response),
+        "<Elster><TransferHeader><TransferTicket>T-%.*s</TransferTicket>"
+        "<RC><Rueckgabe><Code>0</Code><Text>Daten wurden erfolgreich angenommen &amp; verarbeitet</Text></Rueckgabe></RC>"
+        "</TransferHeader><DatenTeil>"
+        "<Nutzdatenblock><NutzdatenHeader><RC><Rueckgabe><Code>0</Code><Text>OK</Text></Rueckgabe></RC></NutzdatenHeader></Nutzdatenblock>"
+        "<Nutzdatenblock><NutzdatenHeader><RC><Rueckgabe><Code>10</Code><Text>Hinweis &lt;a&gt;</Text></Rueckgabe></RC></NutzdatenHeader></Nutzdatenblock>"
+        "</DatenTeil></Elster>",
+        (int) idLen,
+        id
+    );
+    stub_sets(antwort, response);
+
+    return ERIC_OK;
+}
+
+static int stub_answer(
+    const char *xml,
+    EricRueckgabepufferHandle ticket,
+    EricRueckgabepufferHandle codeTH,
+    EricRueckgabepufferHandle textTH,
+    EricRueckgabepufferHandle ndh
+) {
+    const char *th, *thEnd, *value, *header, *code, *text;
+    size_t len, codeLen, textLen;
+    char *out;
+    size_t outLen = 0;
+
+    if(xml == NULL) {
+        return ERIC_GLOBAL_NULL_PARAMETER;
+    }
+    th = stub_tag(xml, NULL, "TransferHeader", &len);
+    if(th == NULL) {
+        return ERIC_IO_PARSE_FEHLER;
+    }
+    thEnd = th + len;
+
+    value = stub_tag(th, thEnd, "TransferTicket", &len);
+    stub_set(ticket, value != NULL ? value : "", value != NULL ? len : 0);
+    value = stub_tag(th, thEnd, "Code", &len);
+    stub_set(codeTH, value != NULL ? value : "", value != NULL ? len : 0);
+    value = stub_tag(th, thEnd, "Text", &len);
+    stub_set_text(textTH, value != NULL ? value : "", value != NULL ? len : 0);
+
+    out = malloc(strlen(xml) + 128);
+    outLen += sprintf(out, "<EricGetErrormessagesFromXMLAnswer>");
+    for(header = thEnd; (header = stub_tag(header, NULL, "NutzdatenHeader", &len)) != NULL; header += len) {
+        code = stub_tag(header, header + len, "Code", &codeLen);
+        text = stub_tag(header, header + len, "Text", &textLen);
+        outLen += sprintf(
+            out + outLen,
+            "<Fehler><Code>%.*s</Code><Meldung>%.*s</Meldung></Fehler>",
+            (int) (code != NULL ? codeLen : 0), code != NULL ? code : "",
+            (int) (text != NULL ? textLen : 0), text != NULL ? text : ""
+        );
+    }
+    outLen += sprintf(out + outLen, "</EricGetErrormessagesFromXMLAnswer>");
+    stub_set(ndh, out, outLen);
+    free(out);
+
+    return ERIC_OK;
+}
+
+static int stub_certificate(EricZertifikatHandle *token, uint32_t *pinSupport, const char *path)
+{
+    const char *support = getenv("ERIC_STUB_PIN_SUPPORT");
+
+    if(path == NULL || access(path, R_OK) != 0) {
+        return ERIC_CRYPT_ZERTIFIKAT;
+    }
+    pthread_mutex_lock(&stub_mutex);
+    *token = stub_next_cert++;
+    pthread_mutex_unlock(&stub_mutex);
+    if(pinSupport != NULL) {
+        *pinSupport = support != NULL ? (uint32_t) atoi(support) : 0;
+    }
+
+    return ERIC_OK;
+}
+
+static int stub_version(EricRueckgabepufferHandle buf)
+{
+    const char *version = getenv("ERIC_STUB_VERSION");
+    char xml[256];
+
+    snprintf(
+        xml,
+        sizeof(xml),
+        "<EricVersion><Bibliothek><Name>libericapi.so</Name><Version>%s</Version></Bibliothek></EricVersion>",
+        version != NULL ? version : "stub-1"
+    );
+    stub_sets(buf, xml);
+
+    return ERIC_OK;
+}
+
+static int stub_fehlertext(int code, EricRueckgabepufferHandle buf)
+{
+    char text[64];
+
+    snprintf(text, sizeof(text), "stub error %d", code);
+    stub_sets(buf, text);
+
+    return ERIC_OK;
+}
+
+/* iban: DE + 20 digits, bic: 8 or 11 characters, idnr: 11 digits, anything else is invalid */
+static int stub_digits(const char *s, size_t from, size_t len)
+{
+    size_t i;
+
+    if(strlen(s) != len) {
+        return 0;
+    }
+    for(i = from; i < len; i++) {
+        if(s[i] < '0' || s[i] > '9') {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+ERICAPI_IMPORT int STDCALL EricInitialisiere(const byteChar *pluginPfad, const byteChar *logPfad)
+{
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricBeende(void)
+{
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT EricRueckgabepufferHandle STDCALL EricRueckgabepufferErzeugen(void)
+{
+    return calloc(1, sizeof(struct EricReturnBufferApi));
+}
+
+ERICAPI_IMPORT int STDCALL EricRueckgabepufferFreigeben(EricRueckgabepufferHandle handle)
+{
+    if(handle == NULL) {
+        return ERIC_GLOBAL_NULL_PARAMETER;
+    }
+    free(handle->data);
+    free(handle);
+
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT const char *STDCALL EricRueckgabepufferInhalt(EricRueckgabepufferHandle handle)
+{
+    return handle != NULL && handle->data != NULL ? handle->data : "";
+}
+
+ERICAPI_IMPORT uint32_t STDCALL EricRueckgabepufferLaenge(EricRueckgabepufferHandle handle)
+{
+    return handle != NULL ? (uint32_t) handle->len : 0;
+}
+
+ERICAPI_IMPORT int STDCALL EricBearbeiteVorgang(
+    const char *datenpuffer,
+    const char *datenartVersion,
+    uint32_t bearbeitungsFlags,
+    const eric_druck_parameter_t *druckParameter,
+    const eric_verschluesselungs_parameter_t *cryptoParameter,
+    EricTransferHandle *transferHandle,
+    EricRueckgabepufferHandle rueckgabeXmlPuffer,
+    EricRueckgabepufferHandle serverantwortXmlPuffer
+) {
+    return stub_bearbeite(&stub_st, datenpuffer, datenartVersion, bearbeitungsFlags, cryptoParameter, rueckgabeXmlPuffer, serverantwortXmlPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricCheckXML(const char *xml, const char *datenartVersion, EricRueckgabepufferHandle fehlertextPuffer)
+{
+    stub_sets(fehlertextPuffer, "");
+
+    return xml != NULL ? stub_tag_int(xml, "StubCode", ERIC_OK) : ERIC_GLOBAL_NULL_PARAMETER;
+}
+
+ERICAPI_IMPORT int STDCALL EricGetErrormessagesFromXMLAnswer(
+    const char *xml,
+    EricRueckgabepufferHandle transferticketPuffer,
+    EricRueckgabepufferHandle returncodeTHPuffer,
+    EricRueckgabepufferHandle fehlertextTHPuffer,
+    EricRueckgabepufferHandle returncodesUndFehlertexteNDHXmlPuffer
+) {
+    return stub_answer(xml, transferticketPuffer, returncodeTHPuffer, fehlertextTHPuffer, returncodesUndFehlertexteNDHXmlPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricGetHandleToCertificate(EricZertifikatHandle *hToken, uint32_t *iInfoPinSupport, const byteChar *pathToKeystore)
+{
+    return stub_certificate(hToken, iInfoPinSupport, pathToKeystore);
+}
+
+ERICAPI_IMPORT int STDCALL EricCloseHandleToCertificate(EricZertifikatHandle hToken)
+{
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricHoleFehlerText(int fehlerkode, EricRueckgabepufferHandle rueckgabePuffer)
+{
+    return stub_fehlertext(fehlerkode, rueckgabePuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricVersion(EricRueckgabepufferHandle rueckgabeXmlPuffer)
+{
+    return stub_version(rueckgabeXmlPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricPruefeIBAN(const byteChar *iban)
+{
+    return iban != NULL && strncmp(iban, "DE", 2) == 0 && stub_digits(iban, 2, 22) ? ERIC_OK : ERIC_GLOBAL_IBAN_FORMALER_FEHLER;
+}
+
+ERICAPI_IMPORT int STDCALL EricPruefeBIC(const byteChar *bic)
+{
+    return bic != NULL && (strlen(bic) == 8 || strlen(bic) == 11) ? ERIC_OK : ERIC_GLOBAL_BIC_FORMALER_FEHLER;
+}
+
+ERICAPI_IMPORT int STDCALL EricPruefeIdentifikationsMerkmal(const byteChar *steuerId)
+{
+    return steuerId != NULL && stub_digits(steuerId, 0, 11) ? ERIC_OK : ERIC_GLOBAL_IDNUMMER_UNGUELTIG;
+}
+
+ERICAPI_IMPORT int STDCALL EricPruefeSteuernummer(const byteChar *steuernummer)
+{
+    return steuernummer != NULL && stub_digits(steuernummer, 0, 13) ? ERIC_OK : ERIC_GLOBAL_STEUERNUMMER_UNGUELTIG;
+}
+
+ERICAPI_IMPORT int STDCALL EricPruefeBuFaNummer(const byteChar *steuernummer)
+{
+    return steuernummer != NULL && stub_digits(steuernummer, 0, 4) ? ERIC_OK : ERIC_GLOBAL_BUFANR_UNBEKANNT;
+}
+
+ERICAPI_IMPORT int STDCALL EricRegistriereLogCallback(EricLogCallback funktion, uint32_t schreibeEricLogDatei, void *benutzerdaten)
+{
+    stub_st.log = funktion;
+    stub_st.logData = benutzerdaten;
+
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricRegistriereFortschrittCallback(EricFortschrittCallback funktion, void *benutzerdaten)
+{
+    stub_st.progress = funktion;
+    stub_st.progressData = benutzerdaten;
+
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricHoleFinanzamtLandNummern(EricRueckgabepufferHandle rueckgabeXmlPuffer)
+{
+    stub_sets(
+        rueckgabeXmlPuffer,
+        "<EricHoleFinanzamtLandNummern><FinanzamtLand><FinanzamtLandNummer>28</FinanzamtLandNummer>"
+        "<Name>Baden-W&#252;rttemberg</Name></FinanzamtLand></EricHoleFinanzamtLandNummern>"
+    );
+
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricHoleFinanzaemter(const byteChar *finanzamtLandNummer, EricRueckgabepufferHandle rueckgabeXmlPuffer)
+{
+    stub_sets(
+        rueckgabeXmlPuffer,
+        "<EricHoleFinanzaemter><Finanzamt><BuFaNummer>2801</BuFaNummer><Name>Offenburg</Name></Finanzamt></EricHoleFinanzaemter>"
+    );
+
+    return ERIC_OK;
+}
+
+/* multithreading api, every instance keeps its own callbacks */
+
+ERICAPI_IMPORT EricInstanzHandle STDCALL EricMtInstanzErzeugen(const char *pluginPfad, const char *logPfad)
+{
+    return getenv("ERIC_STUB_FAIL_INSTANCE") != NULL ? NULL : calloc(1, sizeof(struct EricInstanz));
+}
+
+ERICAPI_IMPORT int STDCALL EricMtInstanzFreigeben(EricInstanzHandle instanz)
+{
+    free(instanz);
+
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT EricRueckgabepufferHandle STDCALL EricMtRueckgabepufferErzeugen(EricInstanzHandle instanz)
+{
+    return EricRueckgabepufferErzeugen();
+}
+
+ERICAPI_IMPORT int STDCALL EricMtRueckgabepufferFreigeben(EricInstanzHandle instanz, EricRueckgabepufferHandle handle)
+{
+    return EricRueckgabepufferFreigeben(handle);
+}
+
+ERICAPI_IMPORT const char *STDCALL EricMtRueckgabepufferInhalt(EricInstanzHandle instanz, EricRueckgabepufferHandle handle)
+{
+    return EricRueckgabepufferInhalt(handle);
+}
+
+ERICAPI_IMPORT uint32_t STDCALL EricMtRueckgabepufferLaenge(EricInstanzHandle instanz, EricRueckgabepufferHandle handle)
+{
+    return EricRueckgabepufferLaenge(handle);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtBearbeiteVorgang(
+    EricInstanzHandle instanz,
+    const char *datenpuffer,
+    const char *datenartVersion,
+    uint32_t bearbeitungsFlags,
+    const eric_druck_parameter_t *druckParameter,
+    const eric_verschluesselungs_parameter_t *cryptoParameter,
+    EricTransferHandle *transferHandle,
+    EricRueckgabepufferHandle rueckgabeXmlPuffer,
+    EricRueckgabepufferHandle serverantwortXmlPuffer
+) {
+    return stub_bearbeite(instanz, datenpuffer, datenartVersion, bearbeitungsFlags, cryptoParameter, rueckgabeXmlPuffer, serverantwortXmlPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtCheckXML(EricInstanzHandle instanz, const char *xml, const char *datenartVersion, EricRueckgabepufferHandle fehlertextPuffer)
+{
+    return EricCheckXML(xml, datenartVersion, fehlertextPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtGetErrormessagesFromXMLAnswer(
+    EricInstanzHandle instanz,
+    const char *xml,
+    EricRueckgabepufferHandle transferticketPuffer,
+    EricRueckgabepufferHandle returncodeTHPuffer,
+    EricRueckgabepufferHandle fehlertextTHPuffer,
+    EricRueckgabepufferHandle returncodesUndFehlertexteNDHXmlPuffer
+) {
+    return stub_answer(xml, transferticketPuffer, returncodeTHPuffer, fehlertextTHPuffer, returncodesUndFehlertexteNDHXmlPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtGetHandleToCertificate(
+    EricInstanzHandle instanz,
+    EricZertifikatHandle *hToken,
+    uint32_t *iInfoPinSupport,
+    const byteChar *pathToKeystore
+) {
+    return stub_certificate(hToken, iInfoPinSupport, pathToKeystore);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtCloseHandleToCertificate(EricInstanzHandle instanz, EricZertifikatHandle hToken)
+{
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricMtHoleFehlerText(EricInstanzHandle instanz, int fehlerkode, EricRueckgabepufferHandle rueckgabePuffer)
+{
+    return stub_fehlertext(fehlerkode, rueckgabePuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtVersion(EricInstanzHandle instanz, EricRueckgabepufferHandle rueckgabeXmlPuffer)
+{
+    return stub_version(rueckgabeXmlPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtPruefeIBAN(EricInstanzHandle instanz, const byteChar *iban)
+{
+    return EricPruefeIBAN(iban);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtPruefeBIC(EricInstanzHandle instanz, const byteChar *bic)
+{
+    return EricPruefeBIC(bic);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtPruefeIdentifikationsMerkmal(EricInstanzHandle instanz, const byteChar *steuerId)
+{
+    return EricPruefeIdentifikationsMerkmal(steuerId);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtPruefeSteuernummer(EricInstanzHandle instanz, const byteChar *steuernummer)
+{
+    return EricPruefeSteuernummer(steuernummer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtPruefeBuFaNummer(EricInstanzHandle instanz, const byteChar *steuernummer)
+{
+    return EricPruefeBuFaNummer(steuernummer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtRegistriereLogCallback(
+    EricInstanzHandle instanz,
+    EricLogCallback funktion,
+    uint32_t schreibeEricLogDatei,
+    void *benutzerdaten
+) {
+    instanz->log = funktion;
+    instanz->logData = benutzerdaten;
+
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricMtRegistriereFortschrittCallback(EricInstanzHandle instanz, EricFortschrittCallback funktion, void *benutzerdaten)
+{
+    instanz->progress = funktion;
+    instanz->progressData = benutzerdaten;
+
+    return ERIC_OK;
+}
+
+ERICAPI_IMPORT int STDCALL EricMtHoleFinanzamtLandNummern(EricInstanzHandle instanz, EricRueckgabepufferHandle rueckgabeXmlPuffer)
+{
+    return EricHoleFinanzamtLandNummern(rueckgabeXmlPuffer);
+}
+
+ERICAPI_IMPORT int STDCALL EricMtHoleFinanzaemter(EricInstanzHandle instanz, const byteChar *finanzamtLandNummer, EricRueckgabepufferHandle rueckgabeXmlPuffer)
+{
+    return EricHoleFinanzaemter(finanzamtLandNummer, rueckgabeXmlPuffer);
+}
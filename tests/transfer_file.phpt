@@ -0,0 +1,29 @@
+--TEST--
+eric_transfer_file() takes paths and streams, rejects what eric_process() rejects
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+--FILE--
+<?php
+$path = __DIR__ . '/transfer_file.tmp.xml';
+file_put_contents($path, '<Elster><StubId>f</StubId></Elster>');
+
+var_dump(is_string(eric_transfer_file($response, 'UStVA_2024', $path, ERIC_VALIDIERE)));
+var_dump(is_string(eric_transfer_file($response, 'UStVA_2024', fopen($path, 'r'), ERIC_VALIDIERE)));
+
+var_dump(eric_transfer_file($response, 'UStVA_2024', $path, 0), eric_get_error_code() === EricError::GLOBAL_UNGUELTIGER_PARAMETER);
+var_dump(eric_process($response, 'UStVA_2024', '<Elster/>', 0), eric_get_error_code() === EricError::GLOBAL_UNGUELTIGER_PARAMETER);
+var_dump(eric_transfer_file($response, 'UStVA_2024', "$path\0.ignored", ERIC_VALIDIERE), eric_get_error_code() === EricError::IO_FEHLER);
+?>
+--CLEAN--
+<?php @unlink(__DIR__ . '/transfer_file.tmp.xml'); ?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(false)
+bool(true)
+bool(false)
+bool(true)
+bool(false)
+bool(true)
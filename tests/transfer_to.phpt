@@ -0,0 +1,44 @@
+--TEST--
+eric_transfer_to() writes into paths, streams and callables
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+--FILE--
+<?php
+$path = __DIR__ . '/transfer_to.tmp.xml';
+$cert = __DIR__ . '/transfer_to.tmp.pfx';
+file_put_contents($cert, 'stub');
+
+$collected = '';
+$collect = function($chunk) use(&$collected) {
+    $collected .= $chunk;
+};
+$result = eric_transfer_to($path, $collect, 'UStVA_2024', '<Elster><StubId>s</StubId></Elster>', ERIC_SENDE, $cert, '123456');
+var_dump($result['code'], $result['return_xml_length'] === filesize($path), $result['server_response_length'] === strlen($collected));
+var_dump(strpos($collected, 'T-s') !== false);
+
+$stream = fopen('php://memory', 'w+');
+$result = eric_transfer_to($stream, null, 'UStVA_2024', '<Elster/>', ERIC_VALIDIERE);
+rewind($stream);
+var_dump($result['return_xml_length'] === strlen(stream_get_contents($stream)), $result['server_response_length']);
+
+try {
+    eric_transfer_to(null, 42, 'UStVA_2024', '<Elster/>');
+} catch(ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--CLEAN--
+<?php
+@unlink(__DIR__ . '/transfer_to.tmp.xml');
+@unlink(__DIR__ . '/transfer_to.tmp.pfx');
+?>
+--EXPECT--
+int(0)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+int(0)
+eric_transfer_to(): Argument #2 ($server_response_sink) must be a path, stream, callable or null
@@ -0,0 +1,64 @@
+--TEST--
+eric_validate_*() return one code per value under the original keys
+--SKIPIF--
+<?php if(!extension_loaded('eric')) die('skip eric not loaded'); ?>
+--INI--
+eric.library_path={PWD}/stub/libericapi.so
+eric.multithreading=1
+eric.instance_pool_size=3
+--FILE--
+<?php
+var_dump(eric_validate_ibans(['a' => 'DE02120300000000202051', 'b' => 'DE0212', 7 => 'FR1420041010050500013M02606']));
+var_dump(eric_validate_bics(['COBADEFFXXX', 'COBADEFF', 'COBA']));
+var_dump(eric_validate_tax_numbers(['2893081508152', '28930']));
+var_dump(eric_validate_tax_office_numbers(['x' => '2801', 'y' => '28']));
+var_dump(eric_validate_ibans([]));
+
+/* spread over worker threads, results must stay in input order */
+$ids = [];
+for($i = 0; $i < 2000; $i++) {
+    $ids["id$i"] = $i % 7 == 0 ? '123' : '12345678901';
+}
+$codes = eric_validate_tax_ids($ids, 4);
+var_dump(count($codes), array_keys($codes) === array_keys($ids));
+$wrong = 0;
+foreach($codes as $key => $code) {
+    $expected = $ids[$key] === '123' ? 610001525 : 0;
+    $wrong += $code !== $expected;
+}
+var_dump($wrong);
+?>
+--EXPECT--
+array(3) {
+  ["a"]=>
+  int(0)
+  ["b"]=>
+  int(610001501)
+  [7]=>
+  int(610001501)
+}
+array(3) {
+  [0]=>
+  int(0)
+  [1]=>
+  int(0)
+  [2]=>
+  int(610001510)
+}
+array(2) {
+  [0]=>
+  int(0)
+  [1]=>
+  int(610001034)
+}
+array(2) {
+  ["x"]=>
+  int(0)
+  ["y"]=>
+  int(610001038)
+}
+array(0) {
+}
+int(2000)
+bool(true)
+int(0)